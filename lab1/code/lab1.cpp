@@ -6,9 +6,18 @@
 #include <algorithm>
 #include <iterator>
 #include <fstream>
+#include <filesystem>
 #include <format>
 #include <functional>
 #include <cassert>
+#include <stdexcept>
+
+#include "stable_partition.h"
+#include "parallel_partition.h"
+#include "simd_partition.h"
+#include "stream_partition.h"
+#include "loader.h"
+#include "multiway_partition.h"
 
 
 /****************************************
@@ -38,21 +47,6 @@ private:
 
 /* ************************ */
 
-namespace TND004 {
-// Iterative algorithm
-void stable_partition_iterative(std::vector<int>& V, std::function<bool(int)> p);
-
-// Auxiliary function that performs the stable partition recursively
-std::vector<int>::iterator stable_partition(std::vector<int>::iterator first,
-                                            std::vector<int>::iterator last,
-                                            std::function<bool(int)> p);
-
-// Divide-and-conquer algorithm
-void stable_partition(std::vector<int>& V, std::function<bool(int)> p) {
-    TND004::stable_partition(std::begin(V), std::end(V), p);  // call auxiliary function
-}
-}  // namespace TND004
-
 void execute(std::vector<int>& V, const std::vector<int>& res);
 
 bool even(int i);
@@ -143,32 +137,29 @@ int main() {
     {
         std::cout << "\n\nTEST PHASE 6: test with long sequence loaded from a file\n\n";
 
-        std::ifstream file("../code/test_data.txt"); // if mac then change this path
-
-        if (!file) {
+        // read the input sequence from file
+        std::vector<int> seq;
+        try {
+            seq = TND004::read_ints_text("../code/test_data.txt");  // if mac then change this path
+        } catch (const std::exception&) {
             std::cout << "Could not open test_data.txt!!\n";
             return 0;
         }
 
-        // read the input sequence from file
-        std::vector<int> seq{std::istream_iterator<int>{file}, std::istream_iterator<int>()};
-        file.close();
-
         std::cout << "\nNumber of items in the sequence: " << std::ssize(seq) << '\n';
 
         /*std::cout << "Sequence:\n";
         std::for_each(std::begin(seq), std::end(seq), Formatter<int>(std::cout, 8, 5));*/
 
         // read the result sequence from file
-        file.open("../code/test_result.txt");  // if mac then change this path
-
-        if (!file) {
+        std::vector<int> res;
+        try {
+            res = TND004::read_ints_text("../code/test_result.txt");  // if mac then change this path
+        } catch (const std::exception&) {
             std::cout << "Could not open test_result.txt!!\n";
             return 0;
         }
 
-        std::vector<int> res{std::istream_iterator<int>{file}, std::istream_iterator<int>()};
-
         std::cout << "\nNumber of items in the result sequence: " << std::ssize(res);
 
         // display expected result sequence
@@ -177,6 +168,69 @@ int main() {
         assert(std::ssize(seq) == std::ssize(res));
 
         execute(seq, res);
+
+        // Partition a binary copy of the sequence in place, through a memory mapping
+        std::cout << "Memory-mapped stable partition\n";
+        const auto bin = std::filesystem::temp_directory_path() / "lab1_test_data.bin";
+        [[maybe_unused]] const auto n_values =
+            TND004::convert_text_to_binary("../code/test_data.txt", bin);
+        assert(n_values == res.size());
+        {
+            TND004::MappedInts mapped{bin};
+            TND004::stable_partition_iterative(std::begin(mapped), std::end(mapped), even);
+            assert(std::equal(std::begin(mapped), std::end(mapped), std::begin(res), std::end(res)));
+        }
+        std::filesystem::remove(bin);
+
+        // The text loader accepts the tokens that operator>> accepts
+        std::cout << "Text loader\n";
+        const auto txt = std::filesystem::temp_directory_path() / "lab1_signs.txt";
+        std::ofstream{txt} << "+7 -3 12\n";
+        assert((TND004::read_ints_text(txt) == std::vector<int>{7, -3, 12}));
+        std::ofstream{txt} << "+7 +-5\n";
+        try {
+            TND004::read_ints_text(txt);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        std::filesystem::remove(txt);
+    }
+
+    /*****************************************************
+     * TEST PHASE 7                                       *
+     ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 7: items that are not trivially copyable\n\n";
+
+        // Items {key, position}: the pieces of four items, but the first, start with an even key
+        const std::vector<int> keys{1, 4, 7, 9, 2, 6, 3, 5, 8, 1, 3, 2, 10, 11, 13, 12};
+        std::vector<std::vector<int>> seq;
+        for (int i = 0; i < std::ssize(keys); ++i) {
+            seq.push_back(std::vector<int>{keys[i], i});
+        }
+        const auto has_even = [](const std::vector<int>& x) { return even(x.front()); };
+
+        auto res = seq;
+        std::stable_partition(std::begin(res), std::end(res), has_even);
+
+        // A buffer smaller than the sequence: the adaptive split passes sub-ranges that start
+        // with items already in place to the buffered pass
+        std::cout << "Adaptive stable partition with a small buffer\n";
+        std::vector<std::vector<int>> buffer;
+        buffer.reserve(4);
+        auto copy_ = seq;
+        TND004::stable_partition_iterative(std::begin(copy_), std::end(copy_), has_even, buffer);
+        assert(copy_ == res);
+
+        std::cout << "Iterative stable partition\n";
+        copy_ = seq;
+        TND004::stable_partition_iterative(copy_, has_even);
+        assert(copy_ == res);
+
+        std::cout << "Divide-and-conquer stable partition\n";
+        copy_ = seq;
+        TND004::stable_partition(copy_, has_even);
+        assert(copy_ == res);
     }
 }
 
@@ -190,6 +244,7 @@ bool even(int i) {
 
 // Used for testing
 void execute(std::vector<int>& V, const std::vector<int>& res) {
+    const std::vector<int> V_original{V};
     std::vector<int> copy_{V};
 
     std::cout << "\n\nIterative stable partition\n";
@@ -200,49 +255,90 @@ void execute(std::vector<int>& V, const std::vector<int>& res) {
     std::cout << "Divide-and-conquer stable partition\n";
     TND004::stable_partition(copy_, even);
     assert(copy_ == res);  // compare with the expected result
-}
 
-// Iterative algorithm
-void TND004::stable_partition_iterative(std::vector<int>& V, std::function<bool(int)> p) {
-    std::vector<int> res_t, res_f;
-    
-    for(int i = 0;i < (int)V.size();i++) // O(n + 2) complexity
+    // Reuse one small scratch buffer: forces the adaptive split on longer sequences
+    std::cout << "Adaptive stable partition with a reused buffer\n";
+    std::vector<int> buffer;
+    buffer.reserve(4);
+    for (int i = 0; i < 2; ++i) {
+        copy_ = V_original;
+        TND004::stable_partition_iterative(std::begin(copy_), std::end(copy_),
+                                           [](int x) { return x % 2 == 0; }, buffer);
+        assert(copy_ == res);
+        assert(buffer.capacity() == 4);  // no reallocation
+    }
+
+    // Small cutoff so that even short sequences are split into parallel tasks
+    std::cout << "Parallel divide-and-conquer stable partition\n";
+    copy_ = V_original;
+    TND004::stable_partition_parallel(std::begin(copy_), std::end(copy_), even,
+                                      TND004::TaskPool::default_pool(), 4);
+    assert(copy_ == res);
+
+    std::cout << std::format("SIMD stable partition ({})\n", TND004::simd::kernel_name());
+    copy_ = V_original;
+    TND004::stable_partition_simd(copy_, TND004::simd::Even{});
+    assert(copy_ == res);
+
+    // Round trip through binary files, with chunks much smaller than the sequence
+    std::cout << "Streaming stable partition\n";
+    const auto dir = std::filesystem::temp_directory_path();
     {
-        if(p(V[i]))
-            res_t.push_back(V[i]);
-        else
-            res_f.push_back(V[i]);
+        std::ofstream out{dir / "lab1_input.bin", std::ios::binary};
+        out.write(reinterpret_cast<const char*>(V_original.data()),
+                  static_cast<std::streamsize>(V_original.size() * sizeof(int)));
     }
 
-    res_t.insert(res_t.end(), res_f.begin(), res_f.end()); // O(n) complexity
+    // A file with the name of the spill file is left alone
+    {
+        std::ofstream other{dir / "lab1_output.bin.spill"};
+        other << "not a spill file";
+    }
 
-    V = res_t; // total: O(2n + 2) => O(n) complexity
-}
+    [[maybe_unused]] const auto n_true = TND004::stable_partition_file<int>(
+        dir / "lab1_input.bin", dir / "lab1_output.bin", even, 7);
+    assert(n_true == static_cast<std::uintmax_t>(std::count_if(std::begin(res), std::end(res), even)));
 
-// Auxiliary function that performs the stable partition recursively
-// Divide-and-conquer algorithm: stable-partition the sub-sequence starting at first and ending
-// at last-1. If there are items with property p then return an iterator to the end of the block
-// containing the items with property p. If there are no items with property p then return first.
-std::vector<int>::iterator TND004::stable_partition(std::vector<int>::iterator first,
-                                                    std::vector<int>::iterator last,
-                                                    std::function<bool(int)> p) {
-    if(first != last) // Make sure the set is not empty
+    copy_.assign(V_original.size(), 0);
     {
-        if(first + 1 != last) // If we're not looking at a one-element set
-        {
-            // Find the middle element
-            std::vector<int>::iterator mid = first + (last - first)/2;
-            
-            // Find the two rotation points by calling the function recursively 
-            std::vector<int>::iterator rot1 = TND004::stable_partition(first, mid, p);
-            std::vector<int>::iterator rot2 = TND004::stable_partition(mid, last, p);
-
-            // Return the point of rotation
-            auto ret = std::rotate(rot1, mid, rot2);
-            return ret;
+        std::ifstream in{dir / "lab1_output.bin", std::ios::binary};
+        in.read(reinterpret_cast<char*>(copy_.data()),
+                static_cast<std::streamsize>(copy_.size() * sizeof(int)));
+    }
+    assert(copy_ == res);
+
+    assert(std::filesystem::file_size(dir / "lab1_output.bin.spill") == 16);
+    std::filesystem::remove(dir / "lab1_output.bin.spill");
+
+    // Partitioning a file into itself would truncate it before it is read
+    try {
+        TND004::stable_partition_file<int>(dir / "lab1_input.bin", dir / "lab1_input.bin", even);
+        assert(false);
+    } catch (const std::invalid_argument&) {
+        assert(std::filesystem::file_size(dir / "lab1_input.bin") == V_original.size() * sizeof(int));
+    }
+
+    std::filesystem::remove(dir / "lab1_input.bin");
+    std::filesystem::remove(dir / "lab1_output.bin");
+
+    // Two buckets: even items (bucket 0) before odd items (bucket 1)
+    std::cout << "Multi-way stable partition\n";
+    copy_ = V_original;
+    const auto bounds = TND004::stable_partition_by_key(std::begin(copy_), std::end(copy_), 2,
+                                                        [](int x) { return even(x) ? 0 : 1; });
+    assert(copy_ == res);
+    assert(std::ssize(bounds) == 3 && bounds[2] == copy_.size());
+    assert(std::all_of(std::begin(copy_), std::begin(copy_) + bounds[1], even));
+
+    // A key outside [0, K) is rejected before any item is moved
+    if (!std::all_of(std::begin(V_original), std::end(V_original), even)) {
+        copy_ = V_original;
+        try {
+            TND004::stable_partition_by_key(std::begin(copy_), std::end(copy_), 2,
+                                            [](int x) { return even(x) ? 0 : -1; });
+            assert(false);
+        } catch (const std::out_of_range&) {
+            assert(copy_ == V_original);
         }
-        else if(p(*first)) // If we're in a one-element set, check if the element's value has property p
-            return last;
     }
-    return first; // Return first as the default case
 }
@@ -0,0 +1,184 @@
+// lab1_bench.cpp : benchmark of the stable partition algorithms
+// Usage: Lab1Bench [max_size] [max_repetitions]
+// Writes CSV to std::cout: one row per algorithm, input size, predicate true-ratio and layout
+// Build with -DCMAKE_BUILD_TYPE=Release to get meaningful numbers
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+#include "stable_partition.h"
+#include "parallel_partition.h"
+#include "simd_partition.h"
+
+/****************************************
+ * Allocation counting                   *
+ *****************************************/
+
+namespace {
+std::atomic<std::uint64_t> bytes_allocated{0};
+}
+
+void* operator new(std::size_t n) {
+    bytes_allocated.fetch_add(n, std::memory_order_relaxed);
+    if (void* p = std::malloc(n == 0 ? 1 : n)) return p;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t n) {
+    return ::operator new(n);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/****************************************
+ * Declarations                          *
+ *****************************************/
+
+struct Algorithm {
+    std::string name;
+    std::function<void(std::vector<int>&, int threshold)> run;  // partition with x < threshold
+};
+
+struct Result {
+    double ns_per_element;
+    std::uint64_t bytes_per_call;
+};
+
+// Values 0..n-1, in increasing order or shuffled
+std::vector<int> make_input(std::size_t n, bool sorted, std::mt19937& gen);
+
+// Best time of up to reps calls, on a fresh copy of input each time
+Result measure(const Algorithm& algo, const std::vector<int>& input, int threshold, int reps);
+
+/****************************************
+ * Main                                  *
+ *****************************************/
+
+int main(int argc, char* argv[]) {
+    const std::size_t max_size = (argc > 1) ? std::stoull(argv[1]) : 1'000'000'000;
+    const int max_reps = (argc > 2) ? std::stoi(argv[2]) : 10;
+
+    // The predicate is x < threshold, as a lambda so that every algorithm can inline it
+    const std::vector<Algorithm> algorithms{
+        {"iterative",
+         [](std::vector<int>& V, int t) {
+             TND004::stable_partition_iterative(V, [t](int x) { return x < t; });
+         }},
+        {"divide_and_conquer",
+         [](std::vector<int>& V, int t) {
+             TND004::stable_partition(V, [t](int x) { return x < t; });
+         }},
+        {"std::stable_partition",
+         [](std::vector<int>& V, int t) {
+             std::stable_partition(std::begin(V), std::end(V), [t](int x) { return x < t; });
+         }},
+        {"parallel",
+         [](std::vector<int>& V, int t) {
+             TND004::stable_partition_parallel(std::begin(V), std::end(V),
+                                               [t](int x) { return x < t; });
+         }},
+        {std::string{"simd_"} + TND004::simd::kernel_name(),
+         [](std::vector<int>& V, int t) {
+             TND004::stable_partition_simd(V, TND004::simd::Less<int>{t});
+         }},
+    };
+
+    std::mt19937 gen{2024};
+
+    std::cout << "algorithm,size,true_ratio,layout,ns_per_element,bytes_allocated\n";
+
+    for (std::size_t n = 1'000; n <= max_size; n *= 10) {
+        // Fewer repetitions for large inputs
+        const int reps = static_cast<int>(
+            std::clamp<std::size_t>(10'000'000 / n, 1, static_cast<std::size_t>(max_reps)));
+
+        for (bool sorted : {true, false}) {
+            std::vector<int> input;
+            try {
+                input = make_input(n, sorted, gen);
+            } catch (const std::bad_alloc&) {
+                std::cerr << "Out of memory at size " << n << ", stopping\n";
+                return 0;
+            }
+
+            for (double ratio : {0.0, 0.5, 1.0}) {
+                const int threshold = static_cast<int>(ratio * static_cast<double>(n));
+
+                for (const auto& algo : algorithms) {
+                    try {
+                        const Result r = measure(algo, input, threshold, reps);
+                        std::cout << algo.name << ',' << n << ',' << ratio << ','
+                                  << (sorted ? "sorted" : "random") << ',' << r.ns_per_element
+                                  << ',' << r.bytes_per_call << '\n';
+                    } catch (const std::bad_alloc&) {
+                        std::cerr << "Out of memory: " << algo.name << " at size " << n << '\n';
+                    }
+                }
+            }
+        }
+    }
+}
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+std::vector<int> make_input(std::size_t n, bool sorted, std::mt19937& gen) {
+    std::vector<int> V(n);
+    std::iota(std::begin(V), std::end(V), 0);
+
+    if (!sorted) std::shuffle(std::begin(V), std::end(V), gen);
+
+    return V;
+}
+
+Result measure(const Algorithm& algo, const std::vector<int>& input, int threshold, int reps) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<int> V;
+    V.reserve(input.size());
+
+    double best_ns = 0.0;
+    std::uint64_t bytes = 0;
+
+    for (int i = 0; i < reps; ++i) {
+        V.assign(std::begin(input), std::end(input));  // not timed
+
+        const std::uint64_t bytes_before = bytes_allocated.load();
+        const auto start = clock::now();
+
+        algo.run(V, threshold);
+
+        const auto stop = clock::now();
+        bytes += bytes_allocated.load() - bytes_before;
+
+        const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+        if (i == 0 || ns < best_ns) best_ns = ns;
+    }
+
+    return {best_ns / static_cast<double>(input.size()), bytes / static_cast<std::uint64_t>(reps)};
+}
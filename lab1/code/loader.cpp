@@ -0,0 +1,279 @@
+#include "loader.h"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TND004 {
+
+namespace {
+
+constexpr std::size_t block_size = std::size_t{1} << 20;  // bytes read from a text file at once
+
+bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Parse the ints in [first, last) and call f(value) for each one
+template <typename F>
+void parse_range(const char* first, const char* last, F&& f) {
+    while (true) {
+        while (first != last && is_space(*first)) ++first;
+        if (first == last) return;
+
+        // A '+' before the digits is accepted by operator>>, but not by std::from_chars
+        // Any other '+' is left to std::from_chars, which rejects it, so "+-5" is invalid
+        const char* token = first;
+        if (*first == '+' && last - first > 1 && first[1] >= '0' && first[1] <= '9') ++first;
+
+        int value;
+        auto [ptr, ec] = std::from_chars(first, last, value);
+        if (ec != std::errc{} || (ptr != last && !is_space(*ptr))) {
+            const char* token_end = first;
+            while (token_end != last && !is_space(*token_end)) ++token_end;
+            throw std::runtime_error{"Invalid int: " + std::string{token, token_end}};
+        }
+
+        f(value);
+        first = ptr;
+    }
+}
+
+// Read the text file at path block by block and call f(value) for every int
+// A token cut by the end of a block is carried over to the next block
+template <typename F>
+void for_each_int(const std::filesystem::path& path, F&& f) {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw std::runtime_error{"Could not open " + path.string()};
+    }
+
+    std::string block(block_size, '\0');
+    std::size_t carry = 0;  // bytes of an unfinished token at the start of block
+
+    while (true) {
+        in.read(block.data() + carry, static_cast<std::streamsize>(block.size() - carry));
+        if (in.bad()) {
+            throw std::runtime_error{"Could not read " + path.string()};
+        }
+
+        const std::size_t n = carry + static_cast<std::size_t>(in.gcount());
+        const bool last_block = in.eof();
+
+        // Only parse up to the last whitespace, the rest may continue in the next block
+        std::size_t end = n;
+        if (!last_block) {
+            while (end > 0 && !is_space(block[end - 1])) --end;
+            if (end == 0) {
+                throw std::runtime_error{"Token too long in " + path.string()};
+            }
+        }
+
+        parse_range(block.data(), block.data() + end, f);
+
+        if (last_block) return;
+
+        carry = n - end;
+        std::memmove(block.data(), block.data() + end, carry);
+    }
+}
+
+std::int32_t to_little_endian(std::int32_t x) {
+    if constexpr (std::endian::native == std::endian::big)
+        return std::byteswap(x);
+    else
+        return x;
+}
+
+}  // namespace
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+MappedInts::MappedInts(const std::filesystem::path& path) {
+    if constexpr (std::endian::native != std::endian::little) {
+        throw std::runtime_error{"MappedInts requires a little-endian host"};
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error{"Could not open " + path.string()};
+    }
+
+    LARGE_INTEGER bytes;
+    if (!GetFileSizeEx(file, &bytes) || bytes.QuadPart % sizeof(std::int32_t) != 0) {
+        CloseHandle(file);
+        throw std::runtime_error{"Not a file of int32 values: " + path.string()};
+    }
+
+    if (bytes.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0) : nullptr;
+        CloseHandle(file);  // the mapping keeps the file open
+
+        if (view == nullptr) {
+            if (mapping) CloseHandle(mapping);
+            throw std::runtime_error{"Could not map " + path.string()};
+        }
+
+        handle_ = mapping;
+        data_ = static_cast<std::int32_t*>(view);
+        size_ = static_cast<std::size_t>(bytes.QuadPart) / sizeof(std::int32_t);
+    } else {
+        CloseHandle(file);
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw std::runtime_error{"Could not open " + path.string()};
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size % sizeof(std::int32_t) != 0) {
+        ::close(fd);
+        throw std::runtime_error{"Not a file of int32 values: " + path.string()};
+    }
+
+    const auto bytes = static_cast<std::size_t>(st.st_size);
+    if (bytes > 0) {
+        void* view = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);  // the mapping keeps the file open
+
+        if (view == MAP_FAILED) {
+            throw std::runtime_error{"Could not map " + path.string()};
+        }
+        ::madvise(view, bytes, MADV_SEQUENTIAL);  // partitioning scans the values in order
+
+        data_ = static_cast<std::int32_t*>(view);
+        size_ = bytes / sizeof(std::int32_t);
+    } else {
+        ::close(fd);
+    }
+#endif
+}
+
+MappedInts::~MappedInts() {
+    unmap();
+}
+
+MappedInts::MappedInts(MappedInts&& M) noexcept
+    : data_{std::exchange(M.data_, nullptr)}
+    , size_{std::exchange(M.size_, 0)}
+    , handle_{std::exchange(M.handle_, nullptr)} {
+}
+
+MappedInts& MappedInts::operator=(MappedInts&& M) noexcept {
+    if (this != &M) {
+        unmap();
+        data_ = std::exchange(M.data_, nullptr);
+        size_ = std::exchange(M.size_, 0);
+        handle_ = std::exchange(M.handle_, nullptr);
+    }
+    return *this;
+}
+
+void MappedInts::flush() {
+    if (data_ == nullptr) return;
+
+#ifdef _WIN32
+    const bool ok = FlushViewOfFile(data_, 0);
+#else
+    const bool ok = ::msync(data_, size_ * sizeof(std::int32_t), MS_SYNC) == 0;
+#endif
+    if (!ok) {
+        throw std::runtime_error{"Could not write the mapped file back"};
+    }
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+void MappedInts::unmap() noexcept {
+    if (data_ == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(handle_);
+#else
+    ::munmap(data_, size_ * sizeof(std::int32_t));
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    handle_ = nullptr;
+}
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+std::vector<int> parse_ints(std::string_view text) {
+    std::vector<int> V;
+    parse_range(text.data(), text.data() + text.size(), [&V](int x) { V.push_back(x); });
+    return V;
+}
+
+std::vector<int> read_ints_text(const std::filesystem::path& path) {
+    std::vector<int> V;
+
+    // A value takes at least two bytes (a digit and a separator)
+    std::error_code ec;
+    if (const auto bytes = std::filesystem::file_size(path, ec); !ec) {
+        V.reserve(static_cast<std::size_t>(bytes / 2));
+    }
+
+    for_each_int(path, [&V](int x) { V.push_back(x); });
+    V.shrink_to_fit();
+    return V;
+}
+
+std::size_t convert_text_to_binary(const std::filesystem::path& text_path,
+                                   const std::filesystem::path& binary_path) {
+    std::ofstream out{binary_path, std::ios::binary | std::ios::trunc};
+    if (!out) {
+        throw std::runtime_error{"Could not open " + binary_path.string()};
+    }
+
+    std::vector<std::int32_t> buffer;
+    buffer.reserve(block_size / sizeof(std::int32_t));
+    std::size_t count = 0;
+
+    auto write_buffer = [&] {
+        out.write(reinterpret_cast<const char*>(buffer.data()),
+                  static_cast<std::streamsize>(buffer.size() * sizeof(std::int32_t)));
+        if (!out) {
+            throw std::runtime_error{"Could not write " + binary_path.string()};
+        }
+        count += buffer.size();
+        buffer.clear();
+    };
+
+    for_each_int(text_path, [&](int x) {
+        buffer.push_back(to_little_endian(static_cast<std::int32_t>(x)));
+        if (buffer.size() == buffer.capacity()) write_buffer();
+    });
+    write_buffer();
+
+    return count;
+}
+
+}  // namespace TND004
@@ -0,0 +1,85 @@
+// loader.h : fast loading of integer sequences
+// Text files of whitespace-separated ints are parsed with std::from_chars (no locale, no streams)
+// Binary files of raw little-endian int32 values can be memory-mapped and modified in place
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace TND004 {
+
+/** Class MappedInts
+ *
+ * Read-write memory mapping of a binary file of little-endian int32 values
+ * Changes made through the mapping (e.g. a stable partition in place) are written back to the file
+ * The file is not copied into memory: pages are loaded by the OS on first access
+ */
+class MappedInts {
+public:
+    /*
+     * Map the file at path
+     * Throw std::runtime_error if the file cannot be mapped or its size is not a multiple of 4
+     */
+    explicit MappedInts(const std::filesystem::path& path);
+
+    /*
+     * Destructor: unmap the file
+     */
+    ~MappedInts();
+
+    MappedInts(const MappedInts&) = delete;
+    MappedInts& operator=(const MappedInts&) = delete;
+
+    MappedInts(MappedInts&& M) noexcept;
+    MappedInts& operator=(MappedInts&& M) noexcept;
+
+    std::int32_t* begin() { return data_; }
+    std::int32_t* end() { return data_ + size_; }
+    const std::int32_t* begin() const { return data_; }
+    const std::int32_t* end() const { return data_ + size_; }
+
+    std::int32_t* data() { return data_; }
+    std::size_t size() const { return size_; }
+
+    std::span<std::int32_t> values() { return {data_, size_}; }
+
+    /*
+     * Write the modified pages back to the file now, instead of when the mapping is closed
+     */
+    void flush();
+
+private:
+    std::int32_t* data_{nullptr};
+    std::size_t size_{0};  // number of values
+    void* handle_{nullptr};  // file mapping handle, only used on Windows
+
+    void unmap() noexcept;
+};
+
+/*
+ * Parse all whitespace-separated ints in text
+ * Throw std::runtime_error if a token is not an int
+ */
+std::vector<int> parse_ints(std::string_view text);
+
+/*
+ * Read all whitespace-separated ints from the text file at path
+ * The file is read in large blocks and parsed with std::from_chars
+ * Throw std::runtime_error if the file cannot be read or a token is not an int
+ */
+std::vector<int> read_ints_text(const std::filesystem::path& path);
+
+/*
+ * Convert the text file at text_path into a binary file of little-endian int32 values
+ * Memory use does not depend on the size of the file
+ * Return the number of values written
+ */
+std::size_t convert_text_to_binary(const std::filesystem::path& text_path,
+                                   const std::filesystem::path& binary_path);
+
+}  // namespace TND004
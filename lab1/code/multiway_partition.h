@@ -0,0 +1,154 @@
+// multiway_partition.h : stable partition into K buckets in two passes
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TND004 {
+
+/****************************************
+ * Declarations                          *
+ *****************************************/
+
+// Stable K-way partition of [first, last): key(x) is a bucket number in [0, K) and items are
+// grouped by increasing bucket number, keeping their relative order inside each bucket.
+// One counting pass computes the bucket sizes and one scatter pass moves every item to its
+// final position in buffer, which is then moved back. key is called twice per item, so it must
+// be cheap and always return the same bucket for the same item.
+// Throw std::out_of_range, before any item is moved, if key returns a number outside [0, K).
+// buffer is only grown when it is too small, so a buffer reused across calls makes them
+// allocation-free (apart from the returned boundaries). The value type must be default
+// constructible.
+// Return the K + 1 bucket boundaries: bucket b is [first + bounds[b], first + bounds[b + 1]).
+template <std::random_access_iterator It, typename KeyFn>
+std::vector<std::size_t> stable_partition_by_key(It first, It last, std::size_t K, KeyFn key,
+                                                 std::vector<std::iter_value_t<It>>& buffer);
+
+template <std::random_access_iterator It, typename KeyFn>
+std::vector<std::size_t> stable_partition_by_key(It first, It last, std::size_t K, KeyFn key) {
+    std::vector<std::iter_value_t<It>> buffer;
+    return TND004::stable_partition_by_key(first, last, K, key, buffer);
+}
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+namespace detail {
+
+// Message of the std::out_of_range thrown for a key outside [0, K)
+// The key is shown if it is an integer or an enumeration
+template <typename Key>
+std::string bucket_error(const Key& raw, std::size_t K) {
+    std::string message = "Bucket ";
+    if constexpr (std::is_integral_v<Key>)
+        message += std::to_string(raw) + ' ';
+    else if constexpr (std::is_enum_v<Key>)
+        message += std::to_string(std::to_underlying(raw)) + ' ';
+
+    message += "is not in [0, ";
+    message += std::to_string(K);
+    message += ')';
+    return message;
+}
+
+// Scatter with one cache-line sized staging area per bucket (software write-combining):
+// items are copied to buffer a whole line at a time, instead of touching K lines for K items
+template <typename It, typename KeyFn, typename T>
+void scatter_write_combining(It first, It last, std::size_t K, KeyFn& key,
+                             std::vector<std::size_t>& next, T* out) {
+    constexpr std::size_t line = std::max<std::size_t>(1, 64 / sizeof(T));
+
+    std::vector<T> staging(K * line);
+    std::vector<std::size_t> fill(K, 0);
+
+    for (It it = first; it != last; ++it) {
+        const auto b = static_cast<std::size_t>(key(*it));
+        assert(b < K);
+
+        T* stage = staging.data() + b * line;
+        stage[fill[b]++] = *it;
+
+        if (fill[b] == line) {
+            std::memcpy(out + next[b], stage, line * sizeof(T));
+            next[b] += line;
+            fill[b] = 0;
+        }
+    }
+
+    for (std::size_t b = 0; b < K; ++b) {
+        std::memcpy(out + next[b], staging.data() + b * line, fill[b] * sizeof(T));
+        next[b] += fill[b];
+    }
+}
+
+template <typename It, typename KeyFn, typename T>
+void scatter_direct(It first, It last, [[maybe_unused]] std::size_t K, KeyFn& key,
+                    std::vector<std::size_t>& next, T* out) {
+    for (It it = first; it != last; ++it) {
+        const auto b = static_cast<std::size_t>(key(*it));
+        assert(b < K);
+        out[next[b]++] = std::move(*it);
+    }
+}
+
+}  // namespace detail
+
+template <std::random_access_iterator It, typename KeyFn>
+std::vector<std::size_t> stable_partition_by_key(It first, It last, std::size_t K, KeyFn key,
+                                                 std::vector<std::iter_value_t<It>>& buffer) {
+    using T = std::iter_value_t<It>;
+
+    assert(K > 0);
+    const auto n = static_cast<std::size_t>(last - first);
+
+    // Pass 1: bucket sizes
+    // The keys are checked here, so that the scatter passes can index with them
+    std::vector<std::size_t> bounds(K + 1, 0);
+    for (It it = first; it != last; ++it) {
+        const auto raw = key(*it);
+        const auto b = static_cast<std::size_t>(raw);  // a negative key is too large
+        if (b >= K) {
+            throw std::out_of_range{detail::bucket_error(raw, K)};
+        }
+        ++bounds[b + 1];
+    }
+
+    for (std::size_t b = 0; b < K; ++b) {
+        bounds[b + 1] += bounds[b];  // bounds[b] = start of bucket b
+    }
+
+    // Nothing to move when all items are in the same bucket
+    for (std::size_t b = 0; b < K; ++b) {
+        if (bounds[b + 1] - bounds[b] == n) return bounds;
+    }
+
+    // Pass 2: scatter every item to its final position
+    if (buffer.size() < n) buffer.resize(n);
+
+    std::vector<std::size_t> next(std::begin(bounds), std::end(bounds) - 1);
+
+    // Staging costs K cache lines: only worth it while they fit comfortably in L1/L2
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (K <= 1024 && n >= 64 * K)
+            detail::scatter_write_combining(first, last, K, key, next, buffer.data());
+        else
+            detail::scatter_direct(first, last, K, key, next, buffer.data());
+    } else {
+        detail::scatter_direct(first, last, K, key, next, buffer.data());
+    }
+
+    std::move(std::begin(buffer), std::begin(buffer) + static_cast<std::ptrdiff_t>(n), first);
+    return bounds;
+}
+
+}  // namespace TND004
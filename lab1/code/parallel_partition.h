@@ -0,0 +1,103 @@
+// parallel_partition.h : parallel divide-and-conquer stable partition
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+#include "stable_partition.h"
+#include "task_pool.h"
+
+namespace TND004 {
+
+/****************************************
+ * Declarations                          *
+ *****************************************/
+
+// Parallel divide-and-conquer algorithm: the two halves are partitioned as independent tasks of
+// the pool and combined with a parallel rotate. Ranges of at most cutoff items are partitioned
+// sequentially. cutoff = 0 picks a cutoff from the input size and the number of threads.
+// p is called concurrently from several threads, so it must be safe to do that.
+// Return an iterator to the end of the block of items with property p.
+template <std::random_access_iterator It, typename Pred>
+It stable_partition_parallel(It first, It last, Pred p, TaskPool& pool = TaskPool::default_pool(),
+                             std::ptrdiff_t cutoff = 0);
+
+// Rotate [first, last) so that mid becomes the first item, using the threads of pool
+// Same result as std::rotate
+template <std::random_access_iterator It>
+It parallel_rotate(It first, It mid, It last, TaskPool& pool, std::ptrdiff_t grain);
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+namespace detail {
+
+// Swap the items in [first, last) pairwise from both ends, as std::reverse does
+template <typename It>
+void parallel_reverse(It first, It last, TaskPool& pool, std::ptrdiff_t grain) {
+    const std::ptrdiff_t n = last - first;
+
+    pool.parallel_for(n / 2, grain, [first, n](std::ptrdiff_t lo, std::ptrdiff_t hi) {
+        for (std::ptrdiff_t i = lo; i < hi; ++i) {
+            std::iter_swap(first + i, first + (n - 1 - i));
+        }
+    });
+}
+
+template <typename It, typename Pred>
+It stable_partition_fork(It first, It last, Pred& p, TaskPool& pool, std::ptrdiff_t cutoff) {
+    if (last - first <= cutoff) {
+        // Sequential leaf: one scratch buffer per thread, reused by all leaves that thread runs
+        thread_local std::vector<std::iter_value_t<It>> buffer;
+        if (static_cast<std::ptrdiff_t>(buffer.capacity()) < cutoff) {
+            try {
+                buffer.reserve(static_cast<std::size_t>(cutoff));
+            } catch (const std::bad_alloc&) {
+                // memory is tight: the adaptive algorithm copes with a smaller buffer
+            }
+        }
+        return TND004::stable_partition_iterative(first, last, std::ref(p), buffer);
+    }
+
+    It mid = first + (last - first) / 2;
+    It rot1, rot2;
+
+    pool.invoke([&] { rot1 = stable_partition_fork(first, mid, p, pool, cutoff); },
+                [&] { rot2 = stable_partition_fork(mid, last, p, pool, cutoff); });
+
+    return TND004::parallel_rotate(rot1, mid, rot2, pool, cutoff);
+}
+
+}  // namespace detail
+
+template <std::random_access_iterator It>
+It parallel_rotate(It first, It mid, It last, TaskPool& pool, std::ptrdiff_t grain) {
+    if (last - first <= grain) return std::rotate(first, mid, last);
+
+    // Block rotate by three reversals: (A B) -> (rev(A) rev(B)) -> rev(rev(A) rev(B)) = (B A)
+    pool.invoke([&] { detail::parallel_reverse(first, mid, pool, grain); },
+                [&] { detail::parallel_reverse(mid, last, pool, grain); });
+    detail::parallel_reverse(first, last, pool, grain);
+
+    return first + (last - mid);
+}
+
+template <std::random_access_iterator It, typename Pred>
+It stable_partition_parallel(It first, It last, Pred p, TaskPool& pool, std::ptrdiff_t cutoff) {
+    if (cutoff <= 0) {
+        // About 8 leaves per thread for load balance, but never tiny leaves
+        const std::ptrdiff_t leaves = 8 * static_cast<std::ptrdiff_t>(pool.concurrency());
+        cutoff = std::max<std::ptrdiff_t>((last - first) / leaves, 1 << 14);
+    }
+
+    return detail::stable_partition_fork(first, last, p, pool, cutoff);
+}
+
+}  // namespace TND004
@@ -0,0 +1,259 @@
+// simd_partition.h : branchless and vectorized stable partition of int and float sequences
+// AVX-512 and AVX2 kernels are used when the compiler targets them (e.g. -march=native),
+// otherwise a portable branchless scalar loop is used
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace TND004 {
+
+/****************************************
+ * Declarations                          *
+ *****************************************/
+
+namespace simd {
+
+// Predicates that can be evaluated on whole vectors
+// Each one is also an ordinary predicate, so it can be used with the other algorithms
+// value_type is the type of the items it tests: the vector masks read the lanes as that type
+
+// x is even, x is an int
+struct Even {
+    using value_type = int;
+
+    bool operator()(int x) const {
+        return (x & 1) == 0;
+    }
+
+#if defined(__AVX512F__)
+    __mmask16 mask(__m512i v) const {
+        return _mm512_testn_epi32_mask(v, _mm512_set1_epi32(1));
+    }
+#endif
+#if defined(__AVX2__)
+    unsigned mask(__m256i v) const {
+        __m256i low_bit = _mm256_and_si256(v, _mm256_set1_epi32(1));
+        __m256i is_even = _mm256_cmpeq_epi32(low_bit, _mm256_setzero_si256());
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(is_even)));
+    }
+#endif
+};
+
+// x is odd, x is an int
+struct Odd {
+    using value_type = int;
+
+    bool operator()(int x) const {
+        return (x & 1) != 0;
+    }
+
+#if defined(__AVX512F__)
+    __mmask16 mask(__m512i v) const {
+        return _mm512_test_epi32_mask(v, _mm512_set1_epi32(1));
+    }
+#endif
+#if defined(__AVX2__)
+    unsigned mask(__m256i v) const {
+        return Even{}.mask(v) ^ 0xFFu;
+    }
+#endif
+};
+
+// x < bound, T is int or float
+template <typename T>
+struct Less {
+    static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>);
+
+    using value_type = T;
+
+    T bound;
+
+    bool operator()(T x) const {
+        return x < bound;
+    }
+
+#if defined(__AVX512F__)
+    __mmask16 mask(__m512i v) const {
+        if constexpr (std::is_same_v<T, int>)
+            return _mm512_cmplt_epi32_mask(v, _mm512_set1_epi32(bound));
+        else
+            return _mm512_cmp_ps_mask(_mm512_castsi512_ps(v), _mm512_set1_ps(bound), _CMP_LT_OQ);
+    }
+#endif
+#if defined(__AVX2__)
+    unsigned mask(__m256i v) const {
+        __m256 m;
+        if constexpr (std::is_same_v<T, int>)
+            m = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(bound), v));
+        else
+            m = _mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_set1_ps(bound), _CMP_LT_OQ);
+        return static_cast<unsigned>(_mm256_movemask_ps(m));
+    }
+#endif
+};
+
+// x >= bound, T is int or float
+template <typename T>
+struct GreaterEqual {
+    static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>);
+
+    using value_type = T;
+
+    T bound;
+
+    bool operator()(T x) const {
+        return x >= bound;
+    }
+
+#if defined(__AVX512F__)
+    __mmask16 mask(__m512i v) const {
+        if constexpr (std::is_same_v<T, int>)
+            return _mm512_cmpge_epi32_mask(v, _mm512_set1_epi32(bound));
+        else
+            return _mm512_cmp_ps_mask(_mm512_castsi512_ps(v), _mm512_set1_ps(bound), _CMP_GE_OQ);
+    }
+#endif
+#if defined(__AVX2__)
+    unsigned mask(__m256i v) const {
+        if constexpr (std::is_same_v<T, int>) {
+            __m256i lt = _mm256_cmpgt_epi32(_mm256_set1_epi32(bound), v);
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lt))) ^ 0xFFu;
+        } else {
+            __m256 m = _mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_set1_ps(bound), _CMP_GE_OQ);
+            return static_cast<unsigned>(_mm256_movemask_ps(m));
+        }
+    }
+#endif
+};
+
+// Name of the kernel selected at compile time: "avx512", "avx2" or "scalar"
+constexpr const char* kernel_name() {
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
+
+}  // namespace simd
+
+// Stable partition of [first, last) with one of the predicates of namespace simd
+// T is int or float, and must be the value_type of the predicate: the vector kernels and the
+// scalar tail would otherwise test different values, e.g. the bits of a float and the float.
+// The items failing p are staged in buffer, which is only grown when it is too small, so a
+// buffer reused across calls makes them allocation-free.
+// Return a pointer to the end of the block of items with property p.
+template <typename T, typename Pred>
+    requires std::same_as<typename Pred::value_type, T>
+T* stable_partition_simd(T* first, T* last, Pred p, std::vector<T>& buffer);
+
+template <typename T, typename Pred>
+    requires std::same_as<typename Pred::value_type, T>
+void stable_partition_simd(std::vector<T>& V, Pred p) {
+    std::vector<T> buffer;
+    TND004::stable_partition_simd(V.data(), V.data() + V.size(), p, buffer);
+}
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+namespace detail {
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+// For every 8-bit mask: lane indices of the set bits, in order, followed by the other lanes
+// Permuting a vector with entry m moves the lanes selected by m to the front (a compress)
+inline constexpr auto compress_lut = [] {
+    std::array<std::array<std::int32_t, 8>, 256> lut{};
+    for (unsigned m = 0; m < 256; ++m) {
+        int k = 0;
+        for (int lane = 0; lane < 8; ++lane)
+            if (m & (1u << lane)) lut[m][k++] = lane;
+        for (int lane = 0; lane < 8; ++lane)
+            if (!(m & (1u << lane))) lut[m][k++] = lane;
+    }
+    return lut;
+}();
+#endif
+
+// Branchless loop: x is written to both outputs and only the right output pointer advances
+template <typename T, typename Pred>
+void partition_scalar(const T* in, const T* last, T*& out_true, T*& out_false, Pred& p) {
+    for (; in != last; ++in) {
+        const T x = *in;
+        const bool c = p(x);
+        *out_true = x;
+        *out_false = x;
+        out_true += c;
+        out_false += !c;
+    }
+}
+
+}  // namespace detail
+
+template <typename T, typename Pred>
+    requires std::same_as<typename Pred::value_type, T>
+T* stable_partition_simd(T* first, T* last, Pred p, std::vector<T>& buffer) {
+    static_assert(std::is_same_v<T, int> || std::is_same_v<T, float>);
+
+    if (first == last) return first;
+
+    // The kernels may write one whole vector past the last item failing p
+    constexpr std::size_t slack = 16;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (buffer.size() < n + slack) buffer.resize(n + slack);
+
+    // Items with property p are compacted in place: out_true never passes the items not read yet
+    T* out_true = first;
+    T* out_false = buffer.data();
+    const T* in = first;
+
+#if defined(__AVX512F__)
+    for (; last - in >= 16; in += 16) {
+        __m512i v = _mm512_loadu_si512(in);
+        __mmask16 m = p.mask(v);
+        _mm512_mask_compressstoreu_epi32(out_true, m, v);
+        _mm512_mask_compressstoreu_epi32(out_false, _knot_mask16(m), v);
+        const int k = std::popcount(static_cast<unsigned>(m));
+        out_true += k;
+        out_false += 16 - k;
+    }
+#elif defined(__AVX2__)
+    for (; last - in >= 8; in += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+        unsigned m = p.mask(v);
+        __m256i to_true = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(detail::compress_lut[m].data()));
+        __m256i to_false = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(detail::compress_lut[m ^ 0xFFu].data()));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_true),
+                            _mm256_permutevar8x32_epi32(v, to_true));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_false),
+                            _mm256_permutevar8x32_epi32(v, to_false));
+        const int k = std::popcount(m);
+        out_true += k;
+        out_false += 8 - k;
+    }
+#endif
+
+    detail::partition_scalar(in, static_cast<const T*>(last), out_true, out_false, p);
+
+    const std::size_t n_false = static_cast<std::size_t>(out_false - buffer.data());
+    std::memcpy(out_true, buffer.data(), n_false * sizeof(T));
+    return out_true;
+}
+
+}  // namespace TND004
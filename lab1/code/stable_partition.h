@@ -0,0 +1,160 @@
+// stable_partition.h : generic stable partition algorithms
+// Iterative (buffered), divide-and-conquer (in place) and adaptive
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <cstddef>
+
+namespace TND004 {
+
+/****************************************
+ * Declarations                          *
+ *****************************************/
+
+// Divide-and-conquer algorithm: stable-partition [first, last) in place, without allocating.
+// Uses O(log n) stack and O(n log n) element moves.
+// Return an iterator to the end of the block of items with property p.
+template <std::random_access_iterator It, typename Pred>
+It stable_partition(It first, It last, Pred p);
+
+// Iterative algorithm using the caller's scratch buffer: at most buffer.capacity() items are
+// kept in the buffer at any time. If the items that fail p do not fit, the range is split with
+// the divide-and-conquer algorithm until every piece fits (the adaptive strategy of std).
+// The buffer is never reallocated, so a buffer reused across calls makes them allocation-free.
+template <std::random_access_iterator It, typename Pred>
+It stable_partition_iterative(It first, It last, Pred p,
+                              std::vector<std::iter_value_t<It>>& buffer);
+
+// Iterative algorithm: request a scratch buffer as large as the range. If memory is tight,
+// smaller buffers are tried and, as a last resort, the divide-and-conquer algorithm is used.
+template <std::random_access_iterator It, typename Pred>
+It stable_partition_iterative(It first, It last, Pred p);
+
+// Convenience overloads for whole containers
+template <typename Container, typename Pred>
+void stable_partition_iterative(Container& V, Pred p) {
+    TND004::stable_partition_iterative(std::begin(V), std::end(V), p);
+}
+
+template <typename Container, typename Pred>
+void stable_partition(Container& V, Pred p) {
+    TND004::stable_partition(std::begin(V), std::end(V), p);  // call auxiliary function
+}
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+namespace detail {
+
+// Recursive step of the divide-and-conquer algorithm
+// Predicate is passed by reference so that stateful or heavy predicates are not copied per level
+template <typename It, typename Pred>
+It stable_partition_rotate(It first, It last, Pred& p) {
+    if (first == last) return first;  // empty set
+
+    if (first + 1 == last)  // one-element set
+        return p(*first) ? last : first;
+
+    It mid = first + (last - first) / 2;
+
+    // Find the two rotation points by calling the function recursively
+    It rot1 = stable_partition_rotate(first, mid, p);
+    It rot2 = stable_partition_rotate(mid, last, p);
+
+    return std::rotate(rot1, mid, rot2);  // return the point of rotation
+}
+
+// Single pass: items with property p are compacted towards first, the others go to the buffer
+// Requires (last - first) <= buffer.capacity()
+template <typename It, typename Pred, typename T>
+It stable_partition_buffered(It first, It last, Pred& p, std::vector<T>& buffer) {
+    buffer.clear();  // keeps the capacity
+
+    It out = first;
+    for (It it = first; it != last; ++it) {
+        if (p(*it)) {
+            // The sub-ranges of the adaptive split are not trimmed: an item may already be in
+            // place, and self-move-assignment empties e.g. a std::vector
+            if (out != it) *out = std::move(*it);
+            ++out;
+        } else {
+            buffer.push_back(std::move(*it));  // never reallocates
+        }
+    }
+
+    std::move(std::begin(buffer), std::end(buffer), out);
+    buffer.clear();
+    return out;
+}
+
+// Adaptive step: buffered pass when the range fits in the buffer, otherwise divide-and-conquer
+template <typename It, typename Pred, typename T>
+It stable_partition_adaptive(It first, It last, Pred& p, std::vector<T>& buffer) {
+    if (last - first <= static_cast<std::ptrdiff_t>(buffer.capacity()))
+        return stable_partition_buffered(first, last, p, buffer);
+
+    if (first + 1 == last)  // one-element set and no buffer at all
+        return p(*first) ? last : first;
+
+    It mid = first + (last - first) / 2;
+
+    It rot1 = stable_partition_adaptive(first, mid, p, buffer);
+    It rot2 = stable_partition_adaptive(mid, last, p, buffer);
+
+    return std::rotate(rot1, mid, rot2);
+}
+
+// Skip the prefix already satisfying p and the suffix already failing p
+// Return the remaining sub-range that needs to be partitioned
+template <typename It, typename Pred>
+std::pair<It, It> trim(It first, It last, Pred& p) {
+    while (first != last && p(*first)) ++first;
+    while (first != last && !p(*(last - 1))) --last;
+    return {first, last};
+}
+
+}  // namespace detail
+
+template <std::random_access_iterator It, typename Pred>
+It stable_partition(It first, It last, Pred p) {
+    return detail::stable_partition_rotate(first, last, p);
+}
+
+template <std::random_access_iterator It, typename Pred>
+It stable_partition_iterative(It first, It last, Pred p,
+                              std::vector<std::iter_value_t<It>>& buffer) {
+    auto [begin, end] = detail::trim(first, last, p);
+
+    if (begin == end) return begin;
+
+    return detail::stable_partition_adaptive(begin, end, p, buffer);
+}
+
+template <std::random_access_iterator It, typename Pred>
+It stable_partition_iterative(It first, It last, Pred p) {
+    auto [begin, end] = detail::trim(first, last, p);
+
+    if (begin == end) return begin;
+
+    std::vector<std::iter_value_t<It>> buffer;
+    for (auto n = end - begin; n > 0; n /= 2) {
+        try {
+            buffer.reserve(static_cast<std::size_t>(n));
+            break;
+        } catch (const std::bad_alloc&) {
+            // memory is tight: try a smaller buffer
+        } catch (const std::length_error&) {
+        }
+    }
+
+    return detail::stable_partition_adaptive(begin, end, p, buffer);
+}
+
+}  // namespace TND004
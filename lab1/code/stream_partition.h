@@ -0,0 +1,179 @@
+// stream_partition.h : out-of-core stable partition of binary files
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <version>
+
+#include "stable_partition.h"
+
+namespace TND004 {
+
+/****************************************
+ * Declarations                          *
+ *****************************************/
+
+// Stable partition of a binary file of T values (raw bytes, native byte order) into file output
+// The input is read in chunks of chunk_size values. The items with property p are written
+// straight to output and the others are spilled to a temporary file next to output, which is
+// appended to output at the end. Peak memory is about two chunks, whatever the file size.
+// The spill file gets a name that no file has, so no existing file is overwritten.
+// Throw std::invalid_argument if input and output are the same file: output is truncated before
+// input is read. Throw std::runtime_error if a file cannot be read or written.
+// Return the number of items with property p.
+template <typename T = std::int32_t, typename Pred>
+std::uintmax_t stable_partition_file(const std::filesystem::path& input,
+                                     const std::filesystem::path& output, Pred p,
+                                     std::size_t chunk_size = std::size_t{1} << 20);
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+namespace detail {
+
+// Remove the spill file however stable_partition_file exits
+class TemporaryFile {
+public:
+    explicit TemporaryFile(std::filesystem::path p) : path_{std::move(p)} {
+    }
+
+    ~TemporaryFile() {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);  // do not throw from a destructor
+    }
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    const std::filesystem::path& path() const {
+        return path_;
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+// Create an empty spill file next to output, named output.spill or output.spill1, output.spill2,
+// ... if that name is taken, and return its path
+inline std::filesystem::path create_spill_file(const std::filesystem::path& output) {
+    for (int i = 0; i < 100; ++i) {
+        auto name = std::filesystem::path{output} += ".spill";
+        if (i > 0) name += std::to_string(i);
+
+#if defined(__cpp_lib_ios_noreplace)
+        std::ofstream file{name, std::ios::binary | std::ios::noreplace};
+#else
+        if (std::filesystem::exists(name)) continue;
+        std::ofstream file{name, std::ios::binary};
+#endif
+        if (file) return name;
+    }
+    throw std::runtime_error{"Could not create a spill file next to " + output.string()};
+}
+
+// Read up to chunk.size() values, return the number of values read
+template <typename T>
+std::size_t read_chunk(std::ifstream& in, std::vector<T>& chunk, const std::filesystem::path& name) {
+    in.read(reinterpret_cast<char*>(chunk.data()),
+            static_cast<std::streamsize>(chunk.size() * sizeof(T)));
+
+    const auto bytes = static_cast<std::size_t>(in.gcount());
+    if (bytes % sizeof(T) != 0) {
+        throw std::runtime_error{"Truncated value at the end of " + name.string()};
+    }
+    if (in.bad()) {
+        throw std::runtime_error{"Could not read " + name.string()};
+    }
+    return bytes / sizeof(T);
+}
+
+template <typename T>
+void write_values(std::ofstream& out, const T* first, std::size_t n,
+                  const std::filesystem::path& name) {
+    out.write(reinterpret_cast<const char*>(first), static_cast<std::streamsize>(n * sizeof(T)));
+    if (!out) {
+        throw std::runtime_error{"Could not write " + name.string()};
+    }
+}
+
+}  // namespace detail
+
+template <typename T, typename Pred>
+std::uintmax_t stable_partition_file(const std::filesystem::path& input,
+                                     const std::filesystem::path& output, Pred p,
+                                     std::size_t chunk_size) {
+    static_assert(std::is_trivially_copyable_v<T>, "values are copied as raw bytes");
+
+    if (chunk_size == 0) chunk_size = 1;
+
+    std::ifstream in{input, std::ios::binary};
+    if (!in) {
+        throw std::runtime_error{"Could not open " + input.string()};
+    }
+
+    std::error_code ec;
+    if (std::filesystem::equivalent(input, output, ec)) {
+        throw std::invalid_argument{"Cannot partition " + input.string() + " into itself"};
+    }
+
+    std::ofstream out{output, std::ios::binary | std::ios::trunc};
+    if (!out) {
+        throw std::runtime_error{"Could not open " + output.string()};
+    }
+
+    detail::TemporaryFile spill{detail::create_spill_file(output)};
+    std::ofstream spill_out{spill.path(), std::ios::binary | std::ios::trunc};
+    if (!spill_out) {
+        throw std::runtime_error{"Could not open " + spill.path().string()};
+    }
+
+    std::vector<T> chunk(chunk_size);
+    std::vector<T> buffer;
+    buffer.reserve(chunk_size);
+
+    std::uintmax_t n_true = 0;
+
+    // Pass 1: partition every chunk, true-items to output and false-items to the spill file
+    while (std::size_t n = detail::read_chunk(in, chunk, input)) {
+        auto first = std::begin(chunk);
+        auto mid = TND004::stable_partition_iterative(first, first + n, p, buffer);
+        const auto k = static_cast<std::size_t>(mid - first);
+
+        detail::write_values(out, chunk.data(), k, output);
+        detail::write_values(spill_out, chunk.data() + k, n - k, spill.path());
+        n_true += k;
+    }
+
+    spill_out.close();
+    if (!spill_out) {
+        throw std::runtime_error{"Could not write " + spill.path().string()};
+    }
+
+    // Pass 2: append the false-items after the true-items
+    std::ifstream spill_in{spill.path(), std::ios::binary};
+    if (!spill_in) {
+        throw std::runtime_error{"Could not open " + spill.path().string()};
+    }
+
+    while (std::size_t n = detail::read_chunk(spill_in, chunk, spill.path())) {
+        detail::write_values(out, chunk.data(), n, output);
+    }
+
+    out.close();
+    if (!out) {
+        throw std::runtime_error{"Could not write " + output.string()};
+    }
+
+    return n_true;
+}
+
+}  // namespace TND004
@@ -0,0 +1,120 @@
+#include "task_pool.h"
+
+#include <algorithm>
+
+namespace TND004 {
+
+namespace {
+// Pool and queue index of the calling thread, if it is a worker thread
+thread_local const TaskPool* this_pool = nullptr;
+thread_local std::size_t this_queue = 0;
+}  // namespace
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+TaskPool::TaskPool(unsigned n_workers) {
+    for (unsigned i = 0; i <= n_workers; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    workers.reserve(n_workers);
+    for (unsigned i = 0; i < n_workers; ++i) {
+        workers.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard lock{sleep_m};
+        stop = true;
+    }
+    sleep_cv.notify_all();
+
+    for (auto& t : workers) {
+        t.join();
+    }
+}
+
+TaskPool& TaskPool::default_pool() {
+    static TaskPool pool{std::max(std::thread::hardware_concurrency(), 1u) - 1};
+    return pool;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+std::size_t TaskPool::my_queue() const {
+    return (this_pool == this) ? this_queue : workers.size();  // last queue is shared
+}
+
+void TaskPool::push(Task* t) {
+    Queue& q = *queues[my_queue()];
+    {
+        std::lock_guard lock{q.m};
+        q.tasks.push_back(t);
+    }
+    {
+        std::lock_guard lock{sleep_m};
+        ++pending;
+    }
+    sleep_cv.notify_one();
+}
+
+bool TaskPool::run_one(std::size_t self) {
+    Task* t = nullptr;
+
+    // Own queue first, newest task
+    {
+        Queue& q = *queues[self];
+        std::lock_guard lock{q.m};
+        if (!q.tasks.empty()) {
+            t = q.tasks.back();
+            q.tasks.pop_back();
+        }
+    }
+
+    // Steal the oldest task (usually the largest piece of work) from another queue
+    for (std::size_t k = 1; t == nullptr && k < queues.size(); ++k) {
+        Queue& q = *queues[(self + k) % queues.size()];
+        std::lock_guard lock{q.m};
+        if (!q.tasks.empty()) {
+            t = q.tasks.front();
+            q.tasks.pop_front();
+        }
+    }
+
+    if (t == nullptr) return false;
+
+    {
+        std::lock_guard lock{sleep_m};
+        --pending;
+    }
+    t->run();
+    return true;
+}
+
+void TaskPool::wait(Task& t) {
+    const std::size_t self = my_queue();
+
+    while (!t.done.load(std::memory_order_acquire)) {
+        if (!run_one(self)) std::this_thread::yield();
+    }
+}
+
+void TaskPool::worker_loop(std::size_t self) {
+    this_pool = this;
+    this_queue = self;
+
+    while (true) {
+        if (run_one(self)) continue;
+
+        std::unique_lock lock{sleep_m};
+        sleep_cv.wait(lock, [this] { return stop || pending > 0; });
+        if (stop && pending == 0) return;
+    }
+}
+
+}  // namespace TND004
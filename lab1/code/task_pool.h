@@ -0,0 +1,171 @@
+// task_pool.h : small work-stealing thread pool for fork-join algorithms
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TND004 {
+
+/** Class TaskPool
+ *
+ * Every worker thread owns a deque of tasks: it pushes and pops its own tasks at the back
+ * (LIFO, good locality) and steals from the front of the other deques when it runs out of work.
+ * Threads that are not workers of the pool share one extra deque.
+ *
+ * Tasks are only created by invoke(), which does not return before the forked task is done,
+ * so tasks live on the stack of the forking thread and the pool never allocates per task.
+ * A thread waiting for its forked task keeps running other tasks instead of blocking.
+ */
+class TaskPool {
+public:
+    /*
+     * Create a pool with n_workers worker threads
+     * The thread calling invoke() also works, so n_workers = cores - 1 uses all cores
+     */
+    explicit TaskPool(unsigned n_workers);
+
+    /*
+     * Destructor: stop and join all worker threads
+     */
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /*
+     * Number of threads that can run tasks at the same time, including the calling thread
+     */
+    unsigned concurrency() const {
+        return static_cast<unsigned>(workers.size()) + 1;
+    }
+
+    /*
+     * Run f() and g(), possibly in parallel, and return when both are done
+     * If f or g throws, the exception is rethrown here (after both have finished)
+     */
+    template <typename F, typename G>
+    void invoke(F&& f, G&& g);
+
+    /*
+     * Call f(lo, hi) for consecutive chunks [lo, hi) of [0, n), with hi - lo <= grain
+     */
+    template <typename F>
+    void parallel_for(std::ptrdiff_t n, std::ptrdiff_t grain, F&& f);
+
+    /*
+     * Pool shared by the whole program, with one thread per core
+     */
+    static TaskPool& default_pool();
+
+private:
+    struct Task {
+        std::atomic<bool> done{false};
+        std::exception_ptr error;
+
+        virtual void execute() = 0;
+
+        void run() {
+            try {
+                execute();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            done.store(true, std::memory_order_release);
+        }
+
+    protected:
+        ~Task() = default;
+    };
+
+    template <typename G>
+    struct TaskImpl final : Task {
+        explicit TaskImpl(G& g) : fn{g} {}
+        void execute() override { fn(); }
+        G& fn;
+    };
+
+    struct Queue {
+        std::mutex m;
+        std::deque<Task*> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // one per worker, plus one for other threads
+    std::vector<std::thread> workers;
+
+    std::mutex sleep_m;
+    std::condition_variable sleep_cv;
+    std::size_t pending{0};  // number of queued tasks, protected by sleep_m
+    bool stop{false};        // protected by sleep_m
+
+    /*
+     * Index of the calling thread's queue
+     */
+    std::size_t my_queue() const;
+
+    void push(Task* t);
+
+    /*
+     * Pop a task from queue self or steal one from another queue, and run it
+     * Return false if no task was found
+     */
+    bool run_one(std::size_t self);
+
+    void wait(Task& t);
+
+    void worker_loop(std::size_t self);
+};
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+template <typename F, typename G>
+void TaskPool::invoke(F&& f, G&& g) {
+    if (workers.empty()) {
+        f();
+        g();
+        return;
+    }
+
+    TaskImpl<std::remove_reference_t<G>> task{g};
+    push(&task);
+
+    try {
+        f();
+    } catch (...) {
+        wait(task);  // task lives on this stack frame
+        throw;
+    }
+
+    wait(task);
+
+    if (task.error) std::rethrow_exception(task.error);
+}
+
+template <typename F>
+void TaskPool::parallel_for(std::ptrdiff_t n, std::ptrdiff_t grain, F&& f) {
+    if (grain < 1) grain = 1;
+
+    auto chunk = [this, grain, &f](auto& self, std::ptrdiff_t lo, std::ptrdiff_t hi) -> void {
+        if (hi - lo <= grain) {
+            if (lo < hi) f(lo, hi);
+            return;
+        }
+        std::ptrdiff_t mid = lo + (hi - lo) / 2;
+        invoke([&] { self(self, lo, mid); }, [&] { self(self, mid, hi); });
+    };
+
+    chunk(chunk, 0, n);
+}
+
+}  // namespace TND004
@@ -0,0 +1,296 @@
+#include "compressed_set.h"
+#include "container.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+/*
+ * Map an int to an unsigned int with the same order: flip the sign bit
+ * The upper 16 bits of the result are the key of the Container of the value
+ */
+std::uint32_t to_unsigned(int val) {
+    return static_cast<std::uint32_t>(val) ^ 0x80000000u;
+}
+
+int to_int(std::uint16_t key, std::uint16_t low) {
+    return static_cast<int>(((static_cast<std::uint32_t>(key) << 16) | low) ^ 0x80000000u);
+}
+
+}  // namespace
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ *  Default constructor :create an empty CompressedSet
+ */
+CompressedSet::CompressedSet() = default;
+
+/*
+ *  Conversion constructor: convert val into a singleton {val}
+ */
+CompressedSet::CompressedSet(int val) {
+    const std::uint32_t u = to_unsigned(val);
+
+    Container& C = chunks.emplace_back(static_cast<std::uint16_t>(u >> 16));
+    C.array.push_back(static_cast<std::uint16_t>(u));
+    C.cardinality = 1;
+    counter = 1;
+}
+
+/*
+ * Constructor to create a CompressedSet from a sorted vector of unique ints
+ * Create a CompressedSet with all ints in sorted vector list_of_values
+ */
+CompressedSet::CompressedSet(const std::vector<int>& list_of_values) {
+    for (int val : list_of_values) {
+        const std::uint32_t u = to_unsigned(val);
+        const auto key = static_cast<std::uint16_t>(u >> 16);
+
+        if (chunks.empty() || chunks.back().key != key) {
+            if (!chunks.empty())
+                chunks.back().normalize();
+            chunks.emplace_back(key);
+        }
+
+        chunks.back().array.push_back(static_cast<std::uint16_t>(u));
+        chunks.back().cardinality++;
+    }
+
+    if (!chunks.empty())
+        chunks.back().normalize();
+
+    counter = list_of_values.size();
+}
+
+CompressedSet::CompressedSet(const CompressedSet& S) = default;
+
+CompressedSet::CompressedSet(CompressedSet&& S) noexcept
+    : chunks{std::move(S.chunks)}, counter{std::exchange(S.counter, 0)} {
+    S.chunks.clear();
+}
+
+CompressedSet& CompressedSet::operator=(const CompressedSet& S) = default;
+
+CompressedSet& CompressedSet::operator=(CompressedSet&& S) noexcept {
+    if (this != &S) {
+        chunks = std::move(S.chunks);
+        counter = std::exchange(S.counter, 0);
+        S.chunks.clear();
+    }
+    return *this;
+}
+
+CompressedSet::~CompressedSet() = default;
+
+/*
+ * Transform the CompressedSet into an empty set
+ */
+void CompressedSet::make_empty() {
+    chunks.clear();
+    counter = 0;
+}
+
+/*
+ * Test whether val belongs to the CompressedSet
+ * Return true if val belongs to the set, otherwise false
+ * This function does not modify the CompressedSet in any way
+ */
+bool CompressedSet::is_member(int val) const {
+    const std::uint32_t u = to_unsigned(val);
+    const auto key = static_cast<std::uint16_t>(u >> 16);
+
+    auto it = std::ranges::lower_bound(chunks, key, {}, &Container::key);
+
+    return it != std::end(chunks) && it->key == key && it->contains(static_cast<std::uint16_t>(u));
+}
+
+/*
+ * Number of bytes allocated to store the values of the CompressedSet
+ */
+size_t CompressedSet::memory_usage() const {
+    size_t bytes = chunks.capacity() * sizeof(Container);
+    for (const Container& C : chunks)
+        bytes += C.memory_usage();
+    return bytes;
+}
+
+/*
+ * Test whether CompressedSet *this and S represent the same set
+ * Return true, if *this has same elemnts as set S
+ * Return false, otherwise
+ */
+bool CompressedSet::operator==(const CompressedSet& S) const {
+    return counter == S.counter && chunks == S.chunks;
+}
+
+/*
+ * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
+ * Return std::partial_ordering::equivalent, if *this == S
+ * Return std::partial_ordering::less, if *this < S
+ * Return std::partial_ordering::greater, if *this > S
+ * Return std::partial_ordering::unordered, otherwise
+ */
+std::partial_ordering CompressedSet::operator<=>(const CompressedSet& S) const {
+    if (*this == S)
+        return std::partial_ordering::equivalent;
+
+    if (counter < S.counter && S.includes(*this))
+        return std::partial_ordering::less;
+
+    if (counter > S.counter && includes(S))
+        return std::partial_ordering::greater;
+
+    return std::partial_ordering::unordered;
+}
+
+/*
+ * Modify CompressedSet *this such that it becomes the union of *this with CompressedSet S
+ * CompressedSet *this is modified and then returned
+ * The Containers are merged by key, Containers with the same key are united
+ */
+CompressedSet& CompressedSet::operator+=(const CompressedSet& S) {
+    if (this == &S || S.is_empty())
+        return *this;
+
+    std::vector<Container> result;
+    result.reserve(chunks.size() + S.chunks.size());
+
+    auto it1 = std::begin(chunks);
+    auto it2 = std::begin(S.chunks);
+
+    while (it1 != std::end(chunks) && it2 != std::end(S.chunks)) {
+        if (it1->key < it2->key) {
+            result.push_back(std::move(*it1++));
+        } else if (it1->key > it2->key) {
+            result.push_back(*it2++);
+        } else {
+            it1->unite(*it2++);
+            result.push_back(std::move(*it1++));
+        }
+    }
+
+    std::move(it1, std::end(chunks), std::back_inserter(result));
+    std::copy(it2, std::end(S.chunks), std::back_inserter(result));
+
+    chunks.swap(result);
+
+    counter = 0;
+    for (const Container& C : chunks)
+        counter += C.cardinality;
+
+    return *this;
+}
+
+/*
+ * Modify CompressedSet *this such that it becomes the intersection of *this with CompressedSet S
+ * CompressedSet *this is modified and then returned
+ * Only Containers with the same key in both sets are kept, and then intersected
+ */
+CompressedSet& CompressedSet::operator*=(const CompressedSet& S) {
+    if (this == &S)
+        return *this;
+
+    auto out = std::begin(chunks);
+    auto it1 = std::begin(chunks);
+    auto it2 = std::begin(S.chunks);
+
+    while (it1 != std::end(chunks) && it2 != std::end(S.chunks)) {
+        if (it1->key < it2->key) {
+            ++it1;
+        } else if (it1->key > it2->key) {
+            ++it2;
+        } else {
+            it1->intersect(*it2++);
+            if (it1->cardinality > 0) {
+                if (out != it1) *out = std::move(*it1);
+                ++out;
+            }
+            ++it1;
+        }
+    }
+
+    chunks.erase(out, std::end(chunks));
+
+    counter = 0;
+    for (const Container& C : chunks)
+        counter += C.cardinality;
+
+    return *this;
+}
+
+/*
+ * Modify CompressedSet *this such that it becomes the Set difference between *this and
+ * CompressedSet S
+ * CompressedSet *this is modified and then returned
+ */
+CompressedSet& CompressedSet::operator-=(const CompressedSet& S) {
+    if (this == &S) {
+        make_empty();
+        return *this;
+    }
+
+    auto out = std::begin(chunks);
+    auto it2 = std::begin(S.chunks);
+
+    for (auto it1 = std::begin(chunks); it1 != std::end(chunks); ++it1) {
+        while (it2 != std::end(S.chunks) && it2->key < it1->key)
+            ++it2;
+
+        if (it2 != std::end(S.chunks) && it2->key == it1->key)
+            it1->subtract(*it2);
+
+        if (it1->cardinality > 0) {
+            if (out != it1) *out = std::move(*it1);
+            ++out;
+        }
+    }
+
+    chunks.erase(out, std::end(chunks));
+
+    counter = 0;
+    for (const Container& C : chunks)
+        counter += C.cardinality;
+
+    return *this;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Test whether all values of CompressedSet S belong to *this
+ * Every Container of S must be included in the Container of *this with the same key
+ */
+bool CompressedSet::includes(const CompressedSet& S) const {
+    auto it1 = std::begin(chunks);
+
+    for (const Container& C : S.chunks) {
+        while (it1 != std::end(chunks) && it1->key < C.key)
+            ++it1;
+
+        if (it1 == std::end(chunks) || it1->key != C.key || !it1->includes(C))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Write CompressedSet *this to stream os
+ */
+void CompressedSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (const Container& C : chunks) {
+            C.for_each([&os, key = C.key](std::uint16_t low) { os << to_int(key, low) << " "; });
+        }
+        os << "}";
+    }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <compare>  // three-way comparison operator <=>
+
+/** Class to represent a Set of ints
+ *
+ * CompressedSet has the same interface as Set, but it stores the values in compressed form,
+ * as in Roaring bitmaps: the 32-bit values are split into 2^16 chunks by their upper 16 bits,
+ * and the lower 16 bits of the values of a chunk are stored in a Container
+ * A Container with few values is a sorted array of 16-bit ints (2 bytes per value) and
+ * a Container with more than 4096 values is a bitmap of 2^16 bits (8 KiB, at most 2 bytes per value)
+ * Sets should not contain repetitions, i.e.
+ * two ints with the same value cannot belong to a CompressedSet
+ *
+ * All CompressedSet operations have a linear time complexity in the number of Containers and
+ * values, in the worst case. Two bitmaps are combined 64 values at a time
+ */
+class CompressedSet {
+
+public:
+    /*
+     *  Default constructor :create an empty CompressedSet
+     */
+    CompressedSet();
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    CompressedSet(int val);
+
+    /*
+     * Constructor to create a CompressedSet from a sorted vector of unique ints
+     * Create a CompressedSet with all ints in sorted vector list_of_values
+     */
+    explicit CompressedSet(const std::vector<int>& list_of_values);
+
+    /*
+     * Copy and move constructors, assignment operators, and destructor
+     * Defined in compressed_set.cpp, where class Container is complete
+     */
+    CompressedSet(const CompressedSet& S);
+    CompressedSet(CompressedSet&& S) noexcept;
+    CompressedSet& operator=(const CompressedSet& S);
+    CompressedSet& operator=(CompressedSet&& S) noexcept;
+    ~CompressedSet();
+
+    /*
+     * Transform the CompressedSet into an empty set
+     */
+    void make_empty();
+
+    /*
+     * Test whether val belongs to the CompressedSet
+     * Return true if val belongs to the set, otherwise false
+     * This function does not modify the CompressedSet in any way
+     * O(log n) binary search for the Container, then a bit test or a binary search
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Test whether the CompressedSet is empty
+     * Return true if the set is empty, otherwise false
+     * This function does not modify the CompressedSet in any way
+     */
+    bool is_empty() const {
+        return (counter == 0);
+    }
+
+    /*
+     * Count the number of values stored in the CompressedSet
+     * Return number of elements in the set
+     * This function does not modify the CompressedSet in any way
+     */
+    size_t cardinality() const {
+        return counter;
+    }
+
+    /*
+     * Number of bytes allocated to store the values of the CompressedSet
+     */
+    size_t memory_usage() const;
+
+    /*
+     * Test whether CompressedSet *this and S represent the same set
+     * Return true, if *this has same elemnts as set S
+     * Return false, otherwise
+     */
+    bool operator==(const CompressedSet& S) const;
+
+    /*
+     * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
+     * Return std::partial_ordering::equivalent, if *this == S
+     * Return std::partial_ordering::less, if *this < S (*this is contained in CompressedSet S)
+     * Return std::partial_ordering::greater, if *this > S (*this constains CompressedSet S)
+     * Return std::partial_ordering::unordered, otherwise (Sets *this and S are not comparable)
+     */
+    std::partial_ordering operator<=>(const CompressedSet& S) const;
+
+    /*
+     * Modify CompressedSet *this such that it becomes the union of *this with CompressedSet S
+     * CompressedSet *this is modified and then returned
+     */
+    CompressedSet& operator+=(const CompressedSet& S);
+
+    /*
+     * Modify CompressedSet *this such that it becomes the intersection of *this with CompressedSet S
+     * CompressedSet *this is modified and then returned
+     */
+    CompressedSet& operator*=(const CompressedSet& S);
+
+    /*
+     * Modify CompressedSet *this such that it becomes the Set difference between *this and
+     * CompressedSet S
+     * CompressedSet *this is modified and then returned
+     */
+    CompressedSet& operator-=(const CompressedSet& S);
+
+private:
+    class Container;  // nested class defined in container.h
+
+    std::vector<Container> chunks;  // Containers with at least one value, sorted by key
+    size_t counter{0};              // number of values in the Set
+
+    /*
+     * Test whether all values of CompressedSet S belong to *this
+     */
+    bool includes(const CompressedSet& S) const;
+
+    /*
+     * Write CompressedSet *this to stream os
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    /*
+     * Overloaded operator<<
+     * \param os ostream object where the set S elements are written
+     */
+    friend std::ostream& operator<<(std::ostream& os, const CompressedSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    /*
+     * Overloaded operator+: Set union S1+S2
+     * Return a new CompressedSet representing the union of S1 with S2, S1+S2
+     */
+    friend CompressedSet operator+(CompressedSet S1, const CompressedSet& S2) {
+        S1 += S2;
+        return S1;
+    }
+
+    /*
+     * Overloaded operator*: Set intersection S1*S2
+     * Return a new CompressedSet representing the intersection of S1 with S2, S1*S2
+     */
+    friend CompressedSet operator*(CompressedSet S1, const CompressedSet& S2) {
+        S1 *= S2;
+        return S1;
+    }
+
+    /*
+     * Overloaded operator-: Set difference S1-S2
+     * Return a new CompressedSet representing the set difference S1-S2
+     */
+    friend CompressedSet operator-(CompressedSet S1, const CompressedSet& S2) {
+        S1 -= S2;
+        return S1;
+    }
+};
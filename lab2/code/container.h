@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/** Class CompressedSet::Container
+ *
+ * This class represents the values of a CompressedSet that share their upper 16 bits (the key)
+ * Only the lower 16 bits of the values are stored, either as a sorted array (sparse Container)
+ * or as a bitmap of 2^16 bits (dense Container)
+ * A Container is an array if and only if it has at most array_max values, so two Containers with
+ * the same values have the same representation
+ * All members of class CompressedSet::Container are public
+ * but only class CompressedSet can access them, since Container is declared in the private part of
+ * class CompressedSet
+ */
+class CompressedSet::Container {
+public:
+    static constexpr std::size_t array_max = 4096;     // larger Containers are bitmaps (8 KiB)
+    static constexpr std::size_t bitmap_words = 1024;  // 2^16 bits
+
+    /*
+     * Constructor: an empty Container for the values with upper 16 bits key
+     */
+    explicit Container(std::uint16_t k) : key{k} {
+    }
+
+    bool is_bitmap() const {
+        return !bitmap.empty();
+    }
+
+    /*
+     * Test whether the value with lower 16 bits low belongs to the Container
+     */
+    bool contains(std::uint16_t low) const {
+        if (is_bitmap())
+            return (bitmap[low >> 6] >> (low & 63)) & 1;
+
+        return std::binary_search(std::begin(array), std::end(array), low);
+    }
+
+    /*
+     * Call f(low) for all values of the Container, in increasing order
+     */
+    template <typename F>
+    void for_each(F f) const {
+        if (!is_bitmap()) {
+            for (std::uint16_t low : array)
+                f(low);
+            return;
+        }
+
+        for (std::size_t w = 0; w < bitmap_words; ++w) {
+            for (std::uint64_t bits = bitmap[w]; bits != 0; bits &= bits - 1)
+                f(static_cast<std::uint16_t>(w * 64 + std::countr_zero(bits)));
+        }
+    }
+
+    /*
+     * Make the Container a bitmap if it has more than array_max values, or an array otherwise
+     */
+    void normalize() {
+        if (is_bitmap() && cardinality <= array_max) {
+            std::vector<std::uint16_t> values;
+            values.reserve(cardinality);
+            for_each([&values](std::uint16_t low) { values.push_back(low); });
+
+            array.swap(values);
+            bitmap = std::vector<std::uint64_t>{};  // free the 8 KiB
+        } else if (!is_bitmap() && cardinality > array_max) {
+            bitmap = to_bitmap();
+            array = std::vector<std::uint16_t>{};
+        }
+    }
+
+    /*
+     * The values of the Container as a bitmap
+     */
+    std::vector<std::uint64_t> to_bitmap() const {
+        if (is_bitmap())
+            return bitmap;
+
+        std::vector<std::uint64_t> bits(bitmap_words, 0);
+        for (std::uint16_t low : array)
+            bits[low >> 6] |= std::uint64_t{1} << (low & 63);
+        return bits;
+    }
+
+    /*
+     * Modify Container *this such that it becomes the union of *this with Container C
+     */
+    void unite(const Container& C) {
+        if (!is_bitmap() && !C.is_bitmap()) {
+            std::vector<std::uint16_t> values;
+            values.reserve(array.size() + C.array.size());
+            std::set_union(std::begin(array), std::end(array), std::begin(C.array),
+                           std::end(C.array), std::back_inserter(values));
+            array.swap(values);
+            cardinality = array.size();
+        } else {
+            if (!is_bitmap()) {
+                bitmap = C.bitmap;  // C is a bitmap, *this is added to a copy of C
+                for (std::uint16_t low : array)
+                    bitmap[low >> 6] |= std::uint64_t{1} << (low & 63);
+                array = std::vector<std::uint16_t>{};
+            } else if (!C.is_bitmap()) {
+                for (std::uint16_t low : C.array)
+                    bitmap[low >> 6] |= std::uint64_t{1} << (low & 63);
+            } else {
+                for (std::size_t w = 0; w < bitmap_words; ++w)
+                    bitmap[w] |= C.bitmap[w];
+            }
+            count_bitmap();
+        }
+
+        normalize();
+    }
+
+    /*
+     * Modify Container *this such that it becomes the intersection of *this with Container C
+     */
+    void intersect(const Container& C) {
+        if (!is_bitmap() && !C.is_bitmap()) {
+            // Merge, the result is written in place
+            std::size_t out = 0;
+            std::size_t i = 0;
+            std::size_t j = 0;
+
+            while (i < array.size() && j < C.array.size()) {
+                if (array[i] < C.array[j])
+                    ++i;
+                else if (array[i] > C.array[j])
+                    ++j;
+                else {
+                    array[out++] = array[i];
+                    ++i;
+                    ++j;
+                }
+            }
+
+            array.resize(out);
+            cardinality = out;
+        } else if (!is_bitmap()) {
+            std::erase_if(array, [&C](std::uint16_t low) { return !C.contains(low); });
+            cardinality = array.size();
+        } else if (!C.is_bitmap()) {
+            std::vector<std::uint16_t> values;
+            values.reserve(C.array.size());
+            for (std::uint16_t low : C.array)
+                if (contains(low)) values.push_back(low);
+
+            array.swap(values);
+            bitmap = std::vector<std::uint64_t>{};
+            cardinality = array.size();
+        } else {
+            for (std::size_t w = 0; w < bitmap_words; ++w)
+                bitmap[w] &= C.bitmap[w];
+            count_bitmap();
+        }
+
+        normalize();
+    }
+
+    /*
+     * Modify Container *this such that it becomes the difference between *this and Container C
+     */
+    void subtract(const Container& C) {
+        if (!is_bitmap() && !C.is_bitmap()) {
+            // Merge, the result is written in place
+            std::size_t out = 0;
+            std::size_t i = 0;
+            std::size_t j = 0;
+
+            while (i < array.size() && j < C.array.size()) {
+                if (array[i] < C.array[j])
+                    array[out++] = array[i++];
+                else if (array[i] > C.array[j])
+                    ++j;
+                else {
+                    ++i;
+                    ++j;
+                }
+            }
+
+            while (i < array.size())
+                array[out++] = array[i++];
+
+            array.resize(out);
+            cardinality = out;
+        } else if (!is_bitmap()) {
+            std::erase_if(array, [&C](std::uint16_t low) { return C.contains(low); });
+            cardinality = array.size();
+        } else {
+            if (!C.is_bitmap()) {
+                for (std::uint16_t low : C.array)
+                    bitmap[low >> 6] &= ~(std::uint64_t{1} << (low & 63));
+            } else {
+                for (std::size_t w = 0; w < bitmap_words; ++w)
+                    bitmap[w] &= ~C.bitmap[w];
+            }
+            count_bitmap();
+        }
+
+        normalize();
+    }
+
+    /*
+     * Test whether all values of Container C belong to *this
+     */
+    bool includes(const Container& C) const {
+        if (C.cardinality > cardinality)
+            return false;
+
+        if (!is_bitmap())  // then C is an array too
+            return std::includes(std::begin(array), std::end(array), std::begin(C.array),
+                                 std::end(C.array));
+
+        if (!C.is_bitmap())
+            return std::ranges::all_of(C.array, [this](std::uint16_t low) { return contains(low); });
+
+        for (std::size_t w = 0; w < bitmap_words; ++w)
+            if ((C.bitmap[w] & ~bitmap[w]) != 0) return false;
+        return true;
+    }
+
+    /*
+     * Test whether Containers *this and C have the same key and the same values
+     * Both are arrays or both are bitmaps, since the representation depends on the cardinality
+     */
+    bool operator==(const Container& C) const {
+        return key == C.key && cardinality == C.cardinality && array == C.array &&
+               bitmap == C.bitmap;
+    }
+
+    /*
+     * Number of bytes allocated for the values
+     */
+    std::size_t memory_usage() const {
+        return array.capacity() * sizeof(std::uint16_t) + bitmap.capacity() * sizeof(std::uint64_t);
+    }
+
+    // Data members
+    std::uint16_t key;                  // upper 16 bits of the values
+    std::size_t cardinality{0};         // number of values
+    std::vector<std::uint16_t> array;   // sorted lower 16 bits of the values, if not a bitmap
+    std::vector<std::uint64_t> bitmap;  // bitmap_words words if a bitmap, otherwise empty
+
+    /*
+     * Recompute the cardinality of a bitmap
+     */
+    void count_bitmap() {
+        cardinality = 0;
+        for (std::uint64_t bits : bitmap)
+            cardinality += static_cast<std::size_t>(std::popcount(bits));
+    }
+};
@@ -0,0 +1,7 @@
+#include "flat_set.h"
+
+/*
+ * Explicit instantiation of the FlatSet of ints: its member functions are compiled here once,
+ * instead of in every file that uses FlatSet (see the extern template declaration in flat_set.h)
+ */
+template class BasicFlatSet<int>;
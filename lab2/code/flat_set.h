@@ -0,0 +1,475 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <compare>  // three-way comparison operator <=>
+
+#include "set_file.h"
+#include "search.h"
+#include "simd_merge.h"
+#include "parallel_merge.h"
+
+/** Class template to represent a Set of values of type T, ordered by Compare
+ *
+ * BasicFlatSet has the same interface as BasicSet, but it is implemented as a sorted std::vector<T>
+ * All values are stored contiguously, so set operations scan memory sequentially
+ * instead of chasing pointers between heap-allocated nodes
+ * Sets should not contain repetitions, i.e.
+ * two equivalent values (neither is ordered before the other by Compare) cannot belong to a FlatSet
+ *
+ * All FlatSet operations have a linear time complexity, in the worst case
+ * For ints and 64-bit integers in increasing order (e.g. FlatSet, below), union, intersection, and
+ * difference use the merge kernels of simd_merge.h and parallel_merge.h; other types use the std::
+ * set algorithms
+ */
+template <typename T, typename Compare = std::less<T>>
+class BasicFlatSet {
+
+public:
+    /*
+     *  Default constructor :create an empty FlatSet
+     */
+    BasicFlatSet() = default;
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    BasicFlatSet(const T& val) : values{val} {
+    }
+
+    /*
+     * Constructor to create a FlatSet from a sorted vector of unique values
+     * Create a FlatSet with all values in sorted vector list_of_values
+     */
+    explicit BasicFlatSet(const std::vector<T>& list_of_values) : values{list_of_values} {
+    }
+
+    /*
+     * Transform the FlatSet into an empty set
+     */
+    void make_empty() {
+        values.clear();
+    }
+
+    /*
+     * Test whether val belongs to the FlatSet
+     * Return true if val belongs to the set, otherwise false
+     * This function does not modify the FlatSet in any way
+     */
+    bool is_member(const T& val) const;
+
+    /*
+     * Test whether the FlatSet is empty
+     * Return true if the set is empty, otherwise false
+     * This function does not modify the FlatSet in any way
+     */
+    bool is_empty() const {
+        return values.empty();
+    }
+
+    /*
+     * Count the number of values stored in the FlatSet
+     * Return number of elements in the set
+     * This function does not modify the FlatSet in any way
+     */
+    size_t cardinality() const {
+        return values.size();
+    }
+
+    /*
+     * Test whether FlatSet *this and S represent the same set
+     * Return true, if *this has same elemnts as set S
+     * Return false, otherwise
+     */
+    bool operator==(const BasicFlatSet& S) const {
+        if constexpr (standard_order)
+            return values == S.values;
+        else
+            return std::ranges::equal(values, S.values, &BasicFlatSet::equivalent);
+    }
+
+    /*
+     * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
+     * Return std::partial_ordering::equivalent, if *this == S
+     * Return std::partial_ordering::less, if *this < S (*this is contained in FlatSet S)
+     * Return std::partial_ordering::greater, if *this > S (*this constains FlatSet S)
+     * Return std::partial_ordering::unordered, otherwise (Sets *this and S are not comparable)
+     */
+    std::partial_ordering operator<=>(const BasicFlatSet& S) const;
+
+    /*
+     * Modify FlatSet *this such that it becomes the union of *this with FlatSet S
+     * FlatSet *this is modified and then returned
+     */
+    BasicFlatSet& operator+=(const BasicFlatSet& S);
+
+    /*
+     * Modify FlatSet *this such that it becomes the intersection of *this with FlatSet S
+     * FlatSet *this is modified and then returned
+     */
+    BasicFlatSet& operator*=(const BasicFlatSet& S);
+
+    /*
+     * Modify FlatSet *this such that it becomes the Set difference between *this and FlatSet S
+     * FlatSet *this is modified and then returned
+     */
+    BasicFlatSet& operator-=(const BasicFlatSet& S);
+
+    /*
+     * Write FlatSet *this to stream os in the binary format of set_file.h (FlatSets of ints only)
+     * \param block_size values per block of the block table, 0 to write no block table
+     */
+    void write_binary(std::ostream& os, std::uint32_t block_size = default_block_size) const
+        requires std::same_as<T, int> && std::same_as<Compare, std::less<int>>
+    {
+        write_sorted_values(os, values.data(), values.size(), block_size);
+    }
+
+    /*
+     * Read a FlatSet written by write_binary from stream is (FlatSets of ints only)
+     * If the data is not valid, the failbit of is is set and an empty FlatSet is returned
+     */
+    static BasicFlatSet read_binary(std::istream& is)
+        requires std::same_as<T, int> && std::same_as<Compare, std::less<int>>
+    {
+        BasicFlatSet S;
+        S.values = read_sorted_values(is);  // the decoded vector is not copied
+        return S;
+    }
+
+private:
+    std::vector<T> values;  // sorted, without repetitions
+
+    // ints or 64-bit integers in increasing order: the merge kernels of simd_merge.h and
+    // parallel_merge.h apply
+    static constexpr bool merge_kernels = MergeValue<T> && std::same_as<Compare, std::less<T>>;
+
+    // Compare is std::less or std::greater: two values are equivalent if and only if they are equal
+    static constexpr bool standard_order =
+        std::same_as<Compare, std::less<T>> || std::same_as<Compare, std::greater<T>>;
+
+    static bool equivalent(const T& a, const T& b) {
+        return !Compare{}(a, b) && !Compare{}(b, a);
+    }
+
+    /*
+     * Set union, intersection, and difference of S1 and S2, merged into a new FlatSet
+     * Used by operator+, operator*, and operator-
+     */
+    static BasicFlatSet merge_union(const BasicFlatSet& S1, const BasicFlatSet& S2);
+    static BasicFlatSet merge_intersection(const BasicFlatSet& S1, const BasicFlatSet& S2);
+    static BasicFlatSet merge_difference(const BasicFlatSet& S1, const BasicFlatSet& S2);
+
+    /*
+     * Write FlatSet *this to stream os
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    /*
+     * Overloaded operator<<
+     * \param os ostream object where the set S elements are written
+     */
+    friend std::ostream& operator<<(std::ostream& os, const BasicFlatSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    /*
+     * Overloaded operator+: Set union S1+S2
+     * Return a new FlatSet representing the union of S1 with S2, S1+S2
+     * The result is merged into a new vector, S1 is not copied first
+     */
+    friend BasicFlatSet operator+(const BasicFlatSet& S1, const BasicFlatSet& S2) {
+        return merge_union(S1, S2);
+    }
+
+    /*
+     * Overloaded operator+ for a temporary S1, e.g. S1+S2 in S1+S2+S3
+     */
+    friend BasicFlatSet operator+(BasicFlatSet&& S1, const BasicFlatSet& S2) {
+        S1 += S2;
+        return std::move(S1);
+    }
+
+    /*
+     * Overloaded operator*: Set intersection S1*S2
+     * Return a new FlatSet representing the intersection of S1 with S2, S1*S2
+     * The result is merged into a new vector, S1 is not copied first
+     */
+    friend BasicFlatSet operator*(const BasicFlatSet& S1, const BasicFlatSet& S2) {
+        return merge_intersection(S1, S2);
+    }
+
+    /*
+     * Overloaded operator* for a temporary S1, the intersection is computed in place
+     */
+    friend BasicFlatSet operator*(BasicFlatSet&& S1, const BasicFlatSet& S2) {
+        S1 *= S2;
+        return std::move(S1);
+    }
+
+    /*
+     * Overloaded operator-: Set difference S1-S2
+     * Return a new FlatSet representing the set difference S1-S2
+     * The result is merged into a new vector, S1 is not copied first
+     */
+    friend BasicFlatSet operator-(const BasicFlatSet& S1, const BasicFlatSet& S2) {
+        return merge_difference(S1, S2);
+    }
+
+    /*
+     * Overloaded operator- for a temporary S1, the difference is computed in place
+     */
+    friend BasicFlatSet operator-(BasicFlatSet&& S1, const BasicFlatSet& S2) {
+        S1 -= S2;
+        return std::move(S1);
+    }
+};
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * Test whether val belongs to the FlatSet
+ * Return true if val belongs to the set, otherwise false
+ * This function does not modify the FlatSet in any way
+ * O(log n) branchless binary search
+ */
+template <typename T, typename Compare>
+bool BasicFlatSet<T, Compare>::is_member(const T& val) const {
+    const T* first = values.data();
+    const T* last = first + values.size();
+    const T* p = branchless_lower_bound(
+        first, values.size(), val, [](const T& x) -> const T& { return x; }, Compare{});
+
+    return p != last && !Compare{}(val, *p);
+}
+
+/*
+ * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
+ * Return std::partial_ordering::equivalent, if *this == S
+ * Return std::partial_ordering::less, if *this < S
+ * Return std::partial_ordering::greater, if *this > S
+ * Return std::partial_ordering::unordered, otherwise
+ */
+template <typename T, typename Compare>
+std::partial_ordering BasicFlatSet<T, Compare>::operator<=>(const BasicFlatSet& S) const {
+    if (*this == S)
+        return std::partial_ordering::equivalent;
+
+    if (cardinality() < S.cardinality() &&
+        std::includes(std::begin(S.values), std::end(S.values), std::begin(values),
+                      std::end(values), Compare{}))
+        return std::partial_ordering::less;
+
+    if (cardinality() > S.cardinality() &&
+        std::includes(std::begin(values), std::end(values), std::begin(S.values),
+                      std::end(S.values), Compare{}))
+        return std::partial_ordering::greater;
+
+    return std::partial_ordering::unordered;
+}
+
+/*
+ * Modify FlatSet *this such that it becomes the union of *this with FlatSet S
+ * FlatSet *this is modified and then returned
+ */
+template <typename T, typename Compare>
+BasicFlatSet<T, Compare>& BasicFlatSet<T, Compare>::operator+=(const BasicFlatSet& S) {
+    if (this == &S || S.is_empty())
+        return *this;
+
+    *this = *this + S;
+    return *this;
+}
+
+/*
+ * Modify FlatSet *this such that it becomes the intersection of *this with FlatSet S
+ * FlatSet *this is modified and then returned
+ * The result is written in place: it is never longer than the part of *this already read
+ */
+template <typename T, typename Compare>
+BasicFlatSet<T, Compare>& BasicFlatSet<T, Compare>::operator*=(const BasicFlatSet& S) {
+    if (this == &S)
+        return *this;
+
+    if constexpr (merge_kernels) {
+        if (values.size() + S.values.size() >= parallel_min_size)  // merged on several threads
+            return *this = *this * S;
+
+        values.resize(sorted_intersection(values.data(), values.size(), S.values.data(),
+                                          S.values.size(), values.data()));
+    } else {
+        auto out = values.begin();
+        auto other = S.values.begin();
+
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            while (other != S.values.end() && Compare{}(*other, *it))
+                ++other;
+
+            if (other == S.values.end())
+                break;
+
+            if (!Compare{}(*it, *other)) {  // *it is in S
+                if (out != it)
+                    *out = std::move(*it);
+                ++out;
+            }
+        }
+
+        values.erase(out, values.end());
+    }
+
+    return *this;
+}
+
+/*
+ * Modify FlatSet *this such that it becomes the Set difference between *this and FlatSet S
+ * FlatSet *this is modified and then returned
+ * The result is written in place: it is never longer than the part of *this already read
+ */
+template <typename T, typename Compare>
+BasicFlatSet<T, Compare>& BasicFlatSet<T, Compare>::operator-=(const BasicFlatSet& S) {
+    if (this == &S)
+    {
+        make_empty();
+        return *this;
+    }
+
+    if constexpr (merge_kernels) {
+        if (values.size() + S.values.size() >= parallel_min_size)  // merged on several threads
+            return *this = *this - S;
+
+        values.resize(sorted_difference(values.data(), values.size(), S.values.data(),
+                                        S.values.size(), values.data()));
+    } else {
+        auto out = values.begin();
+        auto other = S.values.begin();
+
+        for (auto it = values.begin(); it != values.end(); ++it) {
+            while (other != S.values.end() && Compare{}(*other, *it))
+                ++other;
+
+            if (other == S.values.end() || Compare{}(*it, *other)) {  // *it is not in S
+                if (out != it)
+                    *out = std::move(*it);
+                ++out;
+            }
+        }
+
+        values.erase(out, values.end());
+    }
+
+    return *this;
+}
+
+/*
+ * Set union S1+S2, merged into a new FlatSet
+ * Large FlatSets of integers are merged on several threads, see parallel_merge.h
+ */
+template <typename T, typename Compare>
+BasicFlatSet<T, Compare> BasicFlatSet<T, Compare>::merge_union(const BasicFlatSet& S1,
+                                                               const BasicFlatSet& S2) {
+    BasicFlatSet R;
+
+    if constexpr (merge_kernels) {
+        R.values.resize(S1.values.size() + S2.values.size());
+
+        const size_t k = parallel_sorted_union(S1.values.data(), S1.values.size(),
+                                               S2.values.data(), S2.values.size(), R.values.data());
+        R.values.resize(k);
+    } else {
+        R.values.reserve(S1.values.size() + S2.values.size());
+        std::set_union(std::begin(S1.values), std::end(S1.values), std::begin(S2.values),
+                       std::end(S2.values), std::back_inserter(R.values), Compare{});
+    }
+
+    return R;
+}
+
+/*
+ * Set intersection S1*S2, merged into a new FlatSet
+ * Large FlatSets of integers are merged on several threads, see parallel_merge.h
+ */
+template <typename T, typename Compare>
+BasicFlatSet<T, Compare> BasicFlatSet<T, Compare>::merge_intersection(const BasicFlatSet& S1,
+                                                                      const BasicFlatSet& S2) {
+    BasicFlatSet R;
+
+    if constexpr (merge_kernels) {
+        R.values.resize(std::min(S1.values.size(), S2.values.size()));
+
+        const size_t k = parallel_sorted_intersection(S1.values.data(), S1.values.size(),
+                                                      S2.values.data(), S2.values.size(),
+                                                      R.values.data());
+        R.values.resize(k);
+    } else {
+        R.values.reserve(std::min(S1.values.size(), S2.values.size()));
+        std::set_intersection(std::begin(S1.values), std::end(S1.values), std::begin(S2.values),
+                              std::end(S2.values), std::back_inserter(R.values), Compare{});
+    }
+
+    return R;
+}
+
+/*
+ * Set difference S1-S2, merged into a new FlatSet
+ * Large FlatSets of integers are merged on several threads, see parallel_merge.h
+ */
+template <typename T, typename Compare>
+BasicFlatSet<T, Compare> BasicFlatSet<T, Compare>::merge_difference(const BasicFlatSet& S1,
+                                                                    const BasicFlatSet& S2) {
+    BasicFlatSet R;
+
+    if constexpr (merge_kernels) {
+        R.values.resize(S1.values.size());
+
+        const size_t k = parallel_sorted_difference(S1.values.data(), S1.values.size(),
+                                                    S2.values.data(), S2.values.size(),
+                                                    R.values.data());
+        R.values.resize(k);
+    } else {
+        R.values.reserve(S1.values.size());
+        std::set_difference(std::begin(S1.values), std::end(S1.values), std::begin(S2.values),
+                            std::end(S2.values), std::back_inserter(R.values), Compare{});
+    }
+
+    return R;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Write FlatSet *this to stream os
+ */
+template <typename T, typename Compare>
+void BasicFlatSet<T, Compare>::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (const T& v : values) {
+            os << v << " ";
+        }
+        os << "}";
+    }
+}
+
+// The FlatSet of ints is compiled once, in flat_set.cpp
+extern template class BasicFlatSet<int>;
+
+using FlatSet = BasicFlatSet<int>;
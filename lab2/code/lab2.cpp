@@ -2,8 +2,28 @@
 #include <iomanip>
 #include <sstream>
 #include <cassert>
+#include <utility>
+#include <array>
+#include <thread>
+#include <limits>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
 
 #include "set.h"
+#include "flat_set.h"
+#include "compressed_set.h"
+#include "parallel_merge.h"
+#include "set_snapshot.h"
+#include "set_file.h"
+#include "set_for.h"
 
 int main() {
     /*****************************************************
@@ -133,6 +153,22 @@ int main() {
         assert(S1.is_member(3));
         assert(S1.is_member(5));
         assert(S1.is_member(99999) == false);
+        assert(S1.is_member(0) == false);
+
+        // Large enough to be indexed
+        std::vector<int> A2;
+        for (int i = -500; i < 500; ++i) A2.push_back(3 * i);
+        Set S2{A2};
+        FlatSet F2{A2};
+
+        for (int i = -1502; i < 1502; ++i) {
+            assert(S2.is_member(i) == (i % 3 == 0 && i >= -1500 && i < 1500));
+            assert(F2.is_member(i) == S2.is_member(i));
+        }
+
+        S2 -= Set{0};  // the index is rebuilt after every modification
+        assert(S2.is_member(0) == false);
+        assert(S2.is_member(3));
     }
 
     assert(Set::get_count_nodes() == 0);
@@ -198,6 +234,34 @@ int main() {
         assert((S2 == S3) == false);
         assert((S3 > S2) == false);
         assert((S3 < S2) == false);
+
+        // 0 is a value like any other
+        assert((Set{1} <=> Set{0}) == std::partial_ordering::unordered);
+        assert(Set{0} < Set(std::vector<int>{0, 1}));
+        assert(Set{} < Set{0});
+
+        // Test
+        assert(S2.is_disjoint(S3));
+        assert(S1.is_disjoint(S3) == false);
+        assert(S1.is_disjoint(Set{}));
+        assert(Set{0}.is_disjoint(Set{0}) == false);
+
+        // Large sets: the fingerprints and the ranges answer before any merge walk
+        std::vector<int> A6, A7;
+        for (int i = 0; i < 1000; ++i) {
+            A6.push_back(2 * i);
+            A7.push_back(2 * i + 2000);
+        }
+        Set S4{A6};
+        Set S5{A7};
+
+        assert(S4.is_disjoint(S5));
+        assert((S4 <=> S5) == std::partial_ordering::unordered);
+        assert((S4 * S5 + 100) < S4);
+
+        S4 -= Set{998};
+        assert(S4.is_member(998) == false);
+        assert((S4 + 998) > S4);
     }
 
     assert(Set::get_count_nodes() == 0);
@@ -269,6 +333,60 @@ int main() {
         // test
         std::vector<int> A5{1, 5, 8};
         assert(S3 == Set{A5});
+
+        // move: no Node is created and the moved-from Set is empty, but still usable
+        Set S4{std::move(S3)};
+        assert(Set::get_count_nodes() == 16);
+        assert(S3.is_empty() && !S3.is_member(1) && S3 < S1);
+        assert(S4 == Set{A5});
+
+        S3 += S1;
+        assert(S3 == S1);
+
+        S3 = std::move(S4);
+        assert(Set::get_count_nodes() == 16);
+        assert(S3 == Set{A5} && S4.is_empty());
+
+        // every compound operator with a moved-from left operand
+        Set S5{std::move(S3)};
+        S3 *= S1;
+        assert(S3.is_empty());
+        S3 -= S1;
+        assert(S3.is_empty());
+        S3 += S1;
+        assert(S3 == S1);
+
+        S3 = std::move(S5);
+        S5 *= S3;
+        S5 -= S3;
+        assert(S5.is_empty());
+        S5 *= S5;
+        S5 -= S5;
+        S5 += S5;
+        assert(S5.is_empty() && S3 == Set{A5});
+    }
+
+    {
+        // Union and intersection of many sets
+        Set S1{std::vector<int>{1, 3, 5, 8}};
+        Set S2{std::vector<int>{2, 3, 5, 7}};
+        Set S3{std::vector<int>{3, 5, 9}};
+
+        std::vector<int> A;
+        for (int i = 0; i < 1000; ++i) A.push_back(i);
+        Set S4{A};
+
+        [[maybe_unused]] std::array<const Set*, 4> sets{&S1, &S2, &S3, &S4};
+
+        assert(Set::union_all(sets) == S4);
+        assert(Set::intersect_all(sets) == Set(std::vector<int>{3, 5}));
+
+        assert(Set::union_all(std::span(sets).first(3)) ==
+               Set(std::vector<int>{1, 2, 3, 5, 7, 8, 9}));
+        assert(Set::intersect_all(std::span(sets).last(1)) == S4);
+
+        assert(Set::union_all({}).is_empty());
+        assert(Set::intersect_all({}).is_empty());
     }
 
     assert(Set::get_count_nodes() == 0);
@@ -312,5 +430,467 @@ int main() {
     }
     assert(Set::get_count_nodes() == 0);
 
+    /*****************************************************
+     * TEST PHASE 10                                      *
+     * FlatSet backend: same results as Set               *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 10: FlatSet backend\n";
+
+    {
+        std::vector<int> A1{1, 3, 5, 8};
+        std::vector<int> A2{2, 3, 7};
+
+        FlatSet S1{A1};
+        FlatSet S2{A2};
+
+        // Test
+        std::ostringstream os{};
+        os << S1 + S2 << ' ' << S1 * S2 << ' ' << S1 - S2 << ' ' << FlatSet{};
+
+        std::string tmp{os.str()};
+        assert((tmp == std::string{"{ 1 2 3 5 7 8 } { 3 } { 1 5 8 } Set is empty!"}));
+
+        assert(S1.is_member(5));
+        assert(S1.is_member(4) == false);
+        assert((S1 + S2).cardinality() == 6);
+
+        assert(FlatSet(std::vector<int>{3, 5}) <= S1);
+        assert((S1 <= S2) == false);
+        assert((S1 < S1) == false);
+        assert(S1 <= S1);
+        assert(3 < FlatSet{A2});
+
+        FlatSet S3 = 4 - S1 - 5 - (S1 + S2) - 99999;
+        assert(S3 == FlatSet{4});
+
+        S3 = 3 * S2 + 4;
+        assert(S3 == FlatSet(std::vector<int>{3, 4}));
+
+        S1 -= S1;
+        assert(S1.is_empty());
+        S2 *= S2;
+        assert(S2 == FlatSet{A2});
+    }
+
+    {
+        // Large sets use the block merge kernels, and sets of very different sizes use galloping
+        std::vector<int> M3, M5, M15, M3_or_5, M3_not_5;
+        for (int i = 0; i < 3000; ++i) {
+            if (i % 3 == 0) M3.push_back(i);
+            if (i % 5 == 0) M5.push_back(i);
+            if (i % 15 == 0) M15.push_back(i);
+            if (i % 3 == 0 || i % 5 == 0) M3_or_5.push_back(i);
+            if (i % 3 == 0 && i % 5 != 0) M3_not_5.push_back(i);
+        }
+
+        FlatSet S3{M3};
+        FlatSet S5{M5};
+
+        assert(S3 * S5 == FlatSet{M15});
+        assert(S3 + S5 == FlatSet{M3_or_5});
+        assert(S3 - S5 == FlatSet{M3_not_5});
+
+        FlatSet S6{std::vector<int>{-1, 15, 16, 2985, 5000}};
+        assert(S3 * S6 == FlatSet(std::vector<int>{15, 2985}));
+        assert(S6 * S3 == FlatSet(std::vector<int>{15, 2985}));
+        assert(S6 - S3 == FlatSet(std::vector<int>{-1, 16, 5000}));
+        assert((S3 + S6).cardinality() == M3.size() + 3);
+        assert((S3 - S6).cardinality() == M3.size() - 2);
+
+        S3 *= S5;
+        assert(S3 == FlatSet{M15});
+    }
+
+    {
+        // Large sets: parallel merges give the same results as the merges on one thread
+        std::vector<int> M2, M3;
+        for (int i = -1500000; i < 3000000; ++i) {
+            if (i % 2 == 0) M2.push_back(i);
+            if (i % 3 == 0) M3.push_back(i);
+        }
+
+        FlatSet S2{M2};
+        FlatSet S3{M3};
+        const FlatSet union_23 = S2 + S3;
+        const FlatSet intersection_23 = S2 * S3;
+        const FlatSet difference_32 = S3 - S2;
+
+        assert(intersection_23.cardinality() == 750000);
+
+        std::vector<int> out(M2.size() + M3.size());
+        [[maybe_unused]] auto result = [&out](size_t k) {
+            return FlatSet{std::vector<int>(out.data(), out.data() + k)};
+        };
+
+        for (unsigned n_threads : {2u, 3u, 8u}) {
+            [[maybe_unused]] size_t k = parallel_sorted_union(M2.data(), M2.size(), M3.data(),
+                                                              M3.size(), out.data(), n_threads);
+            assert(result(k) == union_23);
+
+            k = parallel_sorted_intersection(M2.data(), M2.size(), M3.data(), M3.size(),
+                                             out.data(), n_threads);
+            assert(result(k) == intersection_23);
+
+            k = parallel_sorted_difference(M3.data(), M3.size(), M2.data(), M2.size(),
+                                           out.data(), n_threads);
+            assert(result(k) == difference_32);
+        }
+    }
+
+    /*****************************************************
+     * TEST PHASE 11                                      *
+     * CompressedSet backend: same results as Set         *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 11: CompressedSet backend\n";
+
+    {
+        std::vector<int> A1{-70000, 1, 3, 5, 8, 70000};
+        std::vector<int> A2{2, 3, 7, 70000};
+
+        CompressedSet S1{A1};
+        CompressedSet S2{A2};
+
+        // Test
+        std::ostringstream os{};
+        os << S1 + S2 << ' ' << S1 * S2 << ' ' << S1 - S2 << ' ' << CompressedSet{};
+
+        std::string tmp{os.str()};
+        assert((tmp == std::string{"{ -70000 1 2 3 5 7 8 70000 } { 3 70000 } { -70000 1 5 8 } "
+                                   "Set is empty!"}));
+
+        assert(S1.is_member(-70000));
+        assert(S1.is_member(0) == false);
+        assert((S1 + S2).cardinality() == 8);
+
+        assert(CompressedSet(std::vector<int>{3, 5}) <= S1);
+        assert((S1 <= S2) == false);
+        assert(S1 <= S1);
+        assert(3 < CompressedSet{A2});
+
+        CompressedSet S3 = 4 - S1 - 5 - (S1 + S2) - 99999;
+        assert(S3 == CompressedSet{4});
+    }
+
+    {
+        // Dense ranges are stored as bitmaps, at most 2 bytes per value
+        std::vector<int> All, Even, Odd;
+        for (int i = -50000; i < 50000; ++i) {
+            All.push_back(i);
+            (i % 2 == 0 ? Even : Odd).push_back(i);
+        }
+
+        CompressedSet S_all{All};
+        CompressedSet S_even{Even};
+        CompressedSet S_odd{Odd};
+
+        assert(S_all.memory_usage() < 3 * All.size());
+        assert(S_all.is_member(-50000) && S_all.is_member(49999) && !S_all.is_member(50000));
+
+        assert(S_even + S_odd == S_all);
+        assert((S_even * S_odd).is_empty());
+        assert(S_all - S_odd == S_even);
+        assert(S_even < S_all);
+        assert((S_even <=> S_odd) == std::partial_ordering::unordered);
+
+        // Intersection of bitmaps with few values left: back to arrays
+        CompressedSet S4 = S_even * CompressedSet{std::vector<int>{-2, 0, 1, 40000}};
+        assert(S4 == CompressedSet(std::vector<int>{-2, 0, 40000}));
+        assert(S4.memory_usage() < 1000);
+    }
+
+    /*****************************************************
+     * TEST PHASE 12                                      *
+     * SetSnapshot: immutable versions shared by threads  *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 12: SetSnapshot and SetPublisher\n";
+
+    {
+        SetSnapshot V0{std::vector<int>{1, 3, 5, 8}};
+        SetSnapshot V1 = V0.insert(4);
+        SetSnapshot V2 = V1.erase(1).erase(8);
+
+        // Test: every version keeps its values
+        std::ostringstream os{};
+        os << V0 << ' ' << V1 << ' ' << V2 << ' ' << SetSnapshot{};
+
+        std::string tmp{os.str()};
+        assert((tmp == std::string{"{ 1 3 5 8 } { 1 3 4 5 8 } { 3 4 5 } Set is empty!"}));
+
+        assert(V1.cardinality() == 5);
+        assert(V2.is_member(4) && !V2.is_member(1));
+        assert(V0.insert(3) == V0);
+        assert(V0.erase(4) == V0);
+        assert(V1.erase(4) == V0);
+        assert(V2 == SetSnapshot(std::vector<int>{3, 4, 5}));
+    }
+
+    {
+        // One writer publishes a new version for each value, readers see complete versions only
+        SetPublisher P;
+        constexpr int n = 2000;
+
+        std::jthread writer{[&P] {
+            for (int i = 0; i < n; ++i)
+                P.update([i](const SetSnapshot& S) { return S.insert(i); });
+        }};
+
+        std::jthread reader{[&P] {
+            size_t seen = 0;
+            while (seen < n) {
+                SetSnapshot S = P.load();
+                const size_t k = S.cardinality();
+
+                assert(k >= seen);  // versions are published in order
+                [[maybe_unused]] const int last = static_cast<int>(k) - 1;
+                assert(k == 0 || (S.is_member(last) && !S.is_member(last + 1)));
+                seen = k;
+            }
+        }};
+
+        writer.join();
+        reader.join();
+        assert(P.load().cardinality() == n);
+    }
+
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 13                                      *
+     * Binary format: write_binary, read_binary,          *
+     * SetView, and MappedSetFile                         *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 13: binary format\n";
+
+    {
+        // Small and large gaps, and the smallest and largest ints
+        std::vector<int> V{std::numeric_limits<int>::min()};
+        for (int i = -1000; i < 1000; i += 3)
+            V.push_back(i);
+        V.push_back(1'000'000);
+        V.push_back(std::numeric_limits<int>::max());
+
+        const Set S1{V};
+        const FlatSet F1{V};
+
+        // Round trips, with and without block table
+        std::stringstream ss{};
+        S1.write_binary(ss);
+        S1.write_binary(ss, 0);
+        F1.write_binary(ss, 7);
+        Set{}.write_binary(ss);
+
+        assert(Set::read_binary(ss) == S1);
+        assert(Set::read_binary(ss) == S1);
+        assert(FlatSet::read_binary(ss) == F1);
+        assert(Set::read_binary(ss).is_empty() && ss);
+
+        // Most deltas take one byte
+        std::ostringstream os{};
+        S1.write_binary(os);
+        const std::string bytes{os.str()};
+        assert(bytes.size() < 2 * V.size());
+
+        // Invalid data sets the failbit
+        std::istringstream truncated{bytes.substr(0, bytes.size() - 1)};
+        assert(Set::read_binary(truncated).is_empty() && truncated.fail());
+
+        // A header whose table and data sizes add up to 1 byte, modulo 2^64: one value, one
+        // block, and 2^64 - 15 bytes of data in a record of 33 bytes
+        std::string wrapped(33, '\0');
+        auto put = [&wrapped](size_t at, std::uint64_t x, int n_bytes) {
+            for (int i = 0; i < n_bytes; ++i)
+                wrapped[at + i] = static_cast<char>(x >> (8 * i));
+        };
+        put(0, 0x53444E54, 4);  // "TNDS"
+        put(4, 1, 4);           // version
+        put(8, 1, 8);           // number of values
+        put(16, 1, 4);          // block_size
+        put(20, 1, 4);          // number of blocks
+        put(24, std::numeric_limits<std::uint64_t>::max() - 14, 8);
+
+        try {
+            SetView{std::as_bytes(std::span{wrapped})};
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+
+        std::istringstream wrapped_is{wrapped};
+        assert(Set::read_binary(wrapped_is).is_empty() && wrapped_is.fail());
+
+        // Several records in a file, mapped read-only
+        const auto path = std::filesystem::temp_directory_path() / "lab2_sets.bin";
+        {
+            std::ofstream file{path, std::ios::binary};
+            S1.write_binary(file);
+            S1.write_binary(file, 0);
+            Set{}.write_binary(file);
+            Set{5}.write_binary(file, 1);
+        }
+
+        {
+            const MappedSetFile file{path.string()};
+            const std::vector<SetView> sets = file.sets();
+            assert(sets.size() == 4);
+
+            for (int k = 0; k < 2; ++k) {
+                assert(sets[k].cardinality() == V.size());
+                assert(sets[k].values() == V);
+
+                for (int val = -1010; val <= 1010; ++val)
+                    assert(sets[k].is_member(val) == S1.is_member(val));
+                assert(sets[k].is_member(std::numeric_limits<int>::min()));
+                assert(sets[k].is_member(std::numeric_limits<int>::max()));
+                assert(!sets[k].is_member(999'999));
+            }
+
+            assert(sets[2].is_empty() && !sets[2].is_member(0));
+
+            std::ostringstream view_os{};
+            view_os << sets[3] << ' ' << sets[2];
+            assert(view_os.str() == std::string{"{ 5 } Set is empty!"});
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 14                                      *
+     * Sets of other types and orders: BasicSet,          *
+     * BasicFlatSet, and SetFor                           *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 14: sets of other types and orders\n";
+
+    {
+        using StringSet = BasicSet<std::string>;
+
+        const StringSet S1{std::vector<std::string>{"apple", "kiwi", "pear"}};
+        const StringSet S2{std::vector<std::string>{"banana", "kiwi"}};
+
+        assert(S1.is_member("kiwi") && !S1.is_member("plum"));
+        assert((S1 + S2).cardinality() == 4);
+        assert(S1 * S2 == StringSet{"kiwi"});
+        assert(S1 - S2 == StringSet(std::vector<std::string>{"apple", "pear"}));
+        assert(StringSet{"kiwi"} < S1);
+
+        std::ostringstream os{};
+        os << (S1 - S2);
+        assert(os.str() == std::string{"{ apple pear }"});
+    }
+    assert(BasicSet<std::string>::get_count_nodes() == 0);
+
+    {
+        // Values sorted in decreasing order
+        using DescendingSet = BasicSet<int, std::greater<int>>;
+
+        const DescendingSet S1{std::vector<int>{9, 5, 1}};
+        const DescendingSet S2{std::vector<int>{7, 5, 3}};
+
+        assert((S1 + S2) == DescendingSet(std::vector<int>{9, 7, 5, 3, 1}));
+        assert((S1 * S2) == DescendingSet{5});
+        assert((S1 - S2) == DescendingSet(std::vector<int>{9, 1}));
+
+        std::ostringstream os{};
+        os << (S1 + S2);
+        assert(os.str() == std::string{"{ 9 7 5 3 1 }"});
+    }
+    assert((BasicSet<int, std::greater<int>>::get_count_nodes() == 0));
+
+    {
+        // 64-bit ids are stored contiguously, strings in nodes
+        static_assert(std::is_same_v<SetFor<long long>, BasicFlatSet<long long>>);
+        static_assert(std::is_same_v<SetFor<std::string>, BasicSet<std::string>>);
+
+        const long long big = 1LL << 40;
+        SetFor<long long> F1{std::vector<long long>{1, big, 2 * big}};
+        const SetFor<long long> F2{std::vector<long long>{big, 3 * big}};
+
+        assert(F1.is_member(2 * big) && !F1.is_member(3 * big));
+
+        F1 += F2;
+        assert(F1.cardinality() == 4);
+        F1 -= F2;
+        assert(F1 == SetFor<long long>(std::vector<long long>{1, 2 * big}));
+        F1 *= F2;
+        assert(F1.is_empty());
+    }
+
+    {
+        // 64-bit integers use the merge kernels: same results as the std:: set algorithms
+        auto test_kernels = [](auto zero) {
+            using T = decltype(zero);
+            using Set64 = SetFor<T>;
+            static_assert(std::is_same_v<Set64, BasicFlatSet<T>>);
+
+            // values far from 0, for unsigned values on both sides of the sign bit of int64_t
+            T base;
+            if constexpr (std::is_signed_v<T>)
+                base = -(T{1} << 40);
+            else
+                base = (T{1} << 63) - 3000;
+
+            auto values = [base](T step, T count) {
+                std::vector<T> V;
+                for (T i = 0; i < count; ++i) V.push_back(base + step * i);
+                return V;
+            };
+
+            // blocks of values, and a short set merged by galloping
+            const std::vector<T> V1 = values(2, 3000);
+            const std::vector<T> V2 = values(3, 2000);
+            const std::vector<T> V3 = values(97, 50);
+
+            for (const auto& [A, B] : {std::pair{V1, V2}, std::pair{V2, V1}, std::pair{V1, V3},
+                                       std::pair{V3, V1}}) {
+                std::vector<T> U, I, D;
+                std::set_union(A.begin(), A.end(), B.begin(), B.end(), std::back_inserter(U));
+                std::set_intersection(A.begin(), A.end(), B.begin(), B.end(),
+                                      std::back_inserter(I));
+                std::set_difference(A.begin(), A.end(), B.begin(), B.end(), std::back_inserter(D));
+
+                const Set64 S1{A};
+                const Set64 S2{B};
+                assert(S1 + S2 == Set64{U});
+                assert(S1 * S2 == Set64{I});
+                assert(S1 - S2 == Set64{D});
+
+                Set64 S3{S1};
+                S3 *= S2;
+                assert(S3 == Set64{I});
+                S3 = S1;
+                S3 -= S2;
+                assert(S3 == Set64{D});
+            }
+
+            // large sets: parallel merges give the same results as the merges on one thread
+            const std::vector<T> M1 = values(2, 800000);
+            const std::vector<T> M2 = values(3, 600000);
+            std::vector<T> out(M1.size() + M2.size());
+            std::vector<T> expected(M1.size() + M2.size());
+
+            [[maybe_unused]] size_t k = parallel_sorted_union(M1.data(), M1.size(), M2.data(),
+                                                              M2.size(), out.data(), 3);
+            assert(k == sorted_union(M1.data(), M1.size(), M2.data(), M2.size(), expected.data()));
+            assert(std::equal(out.begin(), out.begin() + k, expected.begin()));
+
+            k = parallel_sorted_intersection(M1.data(), M1.size(), M2.data(), M2.size(),
+                                             out.data(), 3);
+            assert(k == 266667);  // offsets 6 * i below 1600000
+            assert(k == sorted_intersection(M1.data(), M1.size(), M2.data(), M2.size(),
+                                            expected.data()));
+            assert(std::equal(out.begin(), out.begin() + k, expected.begin()));
+
+            k = parallel_sorted_difference(M2.data(), M2.size(), M1.data(), M1.size(),
+                                           out.data(), 3);
+            assert(k == sorted_difference(M2.data(), M2.size(), M1.data(), M1.size(),
+                                          expected.data()));
+            assert(std::equal(out.begin(), out.begin() + k, expected.begin()));
+        };
+
+        test_kernels(std::int64_t{0});
+        test_kernels(std::uint64_t{0});
+    }
+
     std::cout << "Success!!\n";
 }
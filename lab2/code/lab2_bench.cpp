@@ -0,0 +1,360 @@
+/*
+ * Benchmarks of the Set operations, for all set implementations of lab 2
+ *
+ * Every benchmark runs for Set (the linked list), FlatSet, and CompressedSet, so that a new
+ * implementation can be compared with the others on the same inputs. The arguments are
+ *   n        number of values of each set
+ *   overlap  percentage of the values of one set that belong to the other
+ *   density  percentage of the ints in the range of the values that belong to the sets
+ *            (100: consecutive ints, 1: an average gap of 100)
+ *
+ * Counters reported besides the time:
+ *   items_per_second  values processed per second (the values of both operands)
+ *   allocs/op         calls of operator new per operation
+ *   bytes/op          bytes allocated per operation
+ *   peak_rss_MiB      peak resident memory of the process so far; run a single benchmark
+ *                     (--benchmark_filter) to get the peak of that benchmark alone
+ *
+ * Usage: Lab2Bench [--benchmark_filter=<regex>], e.g. --benchmark_filter=Union/.*Set>
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "set.h"
+#include "flat_set.h"
+#include "compressed_set.h"
+
+/*****************************************************
+ * Allocation counting                                *
+ ******************************************************/
+
+namespace {
+
+std::atomic<std::size_t> n_allocs{0};
+std::atomic<std::size_t> n_bytes{0};
+
+void* counted(void* p, std::size_t size) {
+    if (!p)
+        throw std::bad_alloc{};
+
+    n_allocs.fetch_add(1, std::memory_order_relaxed);
+    n_bytes.fetch_add(size, std::memory_order_relaxed);
+    return p;
+}
+
+}  // namespace
+
+// All other forms of operator new and delete call these ones
+// GCC warns about free() in operator delete once it inlines both, though they match
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    return counted(std::malloc(size ? size : 1), size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    const auto a = static_cast<std::size_t>(align);
+#ifdef _WIN32
+    return counted(_aligned_malloc(size ? size : 1, a), size);
+#else
+    const std::size_t rounded = std::max(a, (size + a - 1) / a * a);  // a multiple of a, as required
+    return counted(std::aligned_alloc(a, rounded), size);
+#endif
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept {
+    operator delete(p, align);
+}
+
+namespace {
+
+/*
+ * Counts the allocations made while the benchmark is measured, and reports the counters
+ */
+class AllocationCounter {
+public:
+    void start() {
+        allocs_at_start = n_allocs.load(std::memory_order_relaxed);
+        bytes_at_start = n_bytes.load(std::memory_order_relaxed);
+    }
+
+    void stop() {
+        allocs += n_allocs.load(std::memory_order_relaxed) - allocs_at_start;
+        bytes += n_bytes.load(std::memory_order_relaxed) - bytes_at_start;
+    }
+
+    void report(benchmark::State& state, std::size_t values_per_op) const {
+        using benchmark::Counter;
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * values_per_op));
+        state.counters["allocs/op"] = Counter(static_cast<double>(allocs), Counter::kAvgIterations);
+        state.counters["bytes/op"] = Counter(static_cast<double>(bytes), Counter::kAvgIterations);
+        state.counters["peak_rss_MiB"] = peak_rss_mib();
+    }
+
+private:
+    std::size_t allocs{0}, allocs_at_start{0};
+    std::size_t bytes{0}, bytes_at_start{0};
+
+    static double peak_rss_mib() {
+#ifdef _WIN32
+        return 0;
+#else
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes
+#else
+        return usage.ru_maxrss / 1024.0;  // KiB
+#endif
+#endif
+    }
+};
+
+/*****************************************************
+ * Input sets                                         *
+ ******************************************************/
+
+/*
+ * Two sorted vectors of n unique ints, with overlap percent of the values in common
+ * The union of both is a run of ints with gaps of 100 / density on average
+ */
+struct Input {
+    std::vector<int> A;
+    std::vector<int> B;
+
+    Input(std::size_t n, int overlap, int density) {
+        const std::size_t common = n * overlap / 100;
+        const std::size_t total = 2 * n - common;  // size of the union
+
+        std::mt19937 gen{static_cast<unsigned>(n * 1009 + overlap * 31 + density)};
+
+        // Label each value of the union: 0 in both, 1 only in A, 2 only in B
+        std::vector<unsigned char> label(total, 0);
+        std::fill(label.begin() + common, label.begin() + n, 1);
+        std::fill(label.begin() + n, label.end(), 2);
+        std::shuffle(label.begin(), label.end(), gen);
+
+        const int max_gap = std::max(1, 2 * 100 / density - 1);  // average gap 100 / density
+        std::uniform_int_distribution<int> gap(1, max_gap);
+
+        A.reserve(n);
+        B.reserve(n);
+
+        int val = -static_cast<int>(total / 2) * ((max_gap + 1) / 2);  // about centered on 0
+        for (unsigned char l : label) {
+            if (l != 2)
+                A.push_back(val);
+            if (l != 1)
+                B.push_back(val);
+            val += gap(gen);
+        }
+    }
+};
+
+/*
+ * Arguments of the benchmarks of two sets: n, overlap, density
+ */
+void two_set_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "overlap", "density"});
+    b->ArgsProduct({{1 << 10, 1 << 14, 1 << 18}, {0, 50, 100}, {100, 10, 1}});
+}
+
+/*
+ * Arguments of the benchmarks of one set: n, density
+ */
+void one_set_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "density"});
+    b->ArgsProduct({{1 << 10, 1 << 14, 1 << 18}, {100, 10, 1}});
+}
+
+/*****************************************************
+ * Benchmarks                                         *
+ ******************************************************/
+
+/*
+ * Set(const std::vector<int>&)
+ */
+template <typename SetType>
+void BM_Construct(benchmark::State& state) {
+    const Input in{static_cast<std::size_t>(state.range(0)), 0, static_cast<int>(state.range(1))};
+    AllocationCounter allocations;
+
+    for (auto _ : state) {
+        allocations.start();
+        SetType S{in.A};
+        allocations.stop();
+        benchmark::DoNotOptimize(S);
+    }
+
+    allocations.report(state, in.A.size());
+}
+
+/*
+ * Copy constructor
+ */
+template <typename SetType>
+void BM_Copy(benchmark::State& state) {
+    const Input in{static_cast<std::size_t>(state.range(0)), 0, static_cast<int>(state.range(1))};
+    const SetType S1{in.A};
+    AllocationCounter allocations;
+
+    for (auto _ : state) {
+        allocations.start();
+        SetType S2{S1};
+        allocations.stop();
+        benchmark::DoNotOptimize(S2);
+    }
+
+    allocations.report(state, in.A.size());
+}
+
+/*
+ * S1 op= S2, op is one of +=, *=, -=
+ * S1 is copied before each operation, the copy is not measured
+ */
+template <typename SetType, typename Op>
+void algebra(benchmark::State& state, Op op) {
+    const Input in{static_cast<std::size_t>(state.range(0)), static_cast<int>(state.range(1)),
+                   static_cast<int>(state.range(2))};
+    const SetType S1{in.A};
+    const SetType S2{in.B};
+    AllocationCounter allocations;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        SetType R{S1};
+        state.ResumeTiming();
+
+        allocations.start();
+        op(R, S2);
+        allocations.stop();
+        benchmark::DoNotOptimize(R);
+
+        state.PauseTiming();  // the destruction of R is not measured
+        R.make_empty();
+        state.ResumeTiming();
+    }
+
+    allocations.report(state, in.A.size() + in.B.size());
+}
+
+template <typename SetType>
+void BM_Union(benchmark::State& state) {
+    algebra<SetType>(state, [](SetType& R, const SetType& S) { R += S; });
+}
+
+template <typename SetType>
+void BM_Intersection(benchmark::State& state) {
+    algebra<SetType>(state, [](SetType& R, const SetType& S) { R *= S; });
+}
+
+template <typename SetType>
+void BM_Difference(benchmark::State& state) {
+    algebra<SetType>(state, [](SetType& R, const SetType& S) { R -= S; });
+}
+
+/*
+ * S1 <=> S2
+ * With overlap 100 the sets are equal, otherwise they are not comparable
+ */
+template <typename SetType>
+void BM_Compare(benchmark::State& state) {
+    const Input in{static_cast<std::size_t>(state.range(0)), static_cast<int>(state.range(1)),
+                   static_cast<int>(state.range(2))};
+    const SetType S1{in.A};
+    const SetType S2{in.B};
+    AllocationCounter allocations;
+
+    for (auto _ : state) {
+        allocations.start();
+        std::partial_ordering result = S1 <=> S2;
+        allocations.stop();
+        benchmark::DoNotOptimize(result);
+    }
+
+    allocations.report(state, in.A.size() + in.B.size());
+}
+
+/*
+ * is_member, for 1024 values of which about half belong to the set
+ * items_per_second counts lookups
+ */
+template <typename SetType>
+void BM_IsMember(benchmark::State& state) {
+    const Input in{static_cast<std::size_t>(state.range(0)), 0, static_cast<int>(state.range(1))};
+    const SetType S{in.A};
+
+    // Half of the queries are values of A, the other half values of B (not in A)
+    std::mt19937 gen{17};
+    std::vector<int> queries(1024);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const std::vector<int>& from = (i % 2 == 0) ? in.A : in.B;
+        queries[i] = from[gen() % from.size()];
+    }
+    std::shuffle(queries.begin(), queries.end(), gen);
+
+    AllocationCounter allocations;
+
+    for (auto _ : state) {
+        allocations.start();
+        std::size_t found = 0;
+        for (int val : queries)
+            found += S.is_member(val);
+        allocations.stop();
+        benchmark::DoNotOptimize(found);
+    }
+
+    allocations.report(state, queries.size());
+}
+
+}  // namespace
+
+#define LAB2_BENCHMARK(name, args)                     \
+    BENCHMARK_TEMPLATE(name, Set)->Apply(args);         \
+    BENCHMARK_TEMPLATE(name, FlatSet)->Apply(args);     \
+    BENCHMARK_TEMPLATE(name, CompressedSet)->Apply(args)
+
+LAB2_BENCHMARK(BM_Construct, one_set_args);
+LAB2_BENCHMARK(BM_Copy, one_set_args);
+LAB2_BENCHMARK(BM_Union, two_set_args);
+LAB2_BENCHMARK(BM_Intersection, two_set_args);
+LAB2_BENCHMARK(BM_Difference, two_set_args);
+LAB2_BENCHMARK(BM_Compare, two_set_args);
+LAB2_BENCHMARK(BM_IsMember, one_set_args);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,136 @@
+#include "parallel_merge.h"
+#include "simd_merge.h"
+#include "search.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t min_part_size = parallel_min_size / 4;  // values per thread, at least
+
+/*
+ * Merge a[0, n) and b[0, m) with kernel, in parts on separate threads
+ * Part p is written at out + offset(first value of part p in a, first value of part p in b),
+ * and the parts are then moved next to each other
+ * offset must give disjoint regions of out that are large enough for the results of the parts
+ */
+template <typename T, typename Kernel, typename Offset>
+std::size_t merge_parts(const T* a, std::size_t n, const T* b, std::size_t m, T* out,
+                        unsigned n_threads, Kernel kernel, Offset offset) {
+    if (n_threads == 0)
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const std::size_t parts =
+        (n + m < parallel_min_size) ? 1 : std::min<std::size_t>(n_threads, (n + m) / min_part_size);
+
+    if (parts < 2)
+        return kernel(a, n, b, m, out);
+
+    // Part p is a[a_cut[p], a_cut[p+1]) and b[b_cut[p], b_cut[p+1]): the values in the same range
+    std::vector<std::size_t> a_cut(parts + 1, 0);
+    std::vector<std::size_t> b_cut(parts + 1, 0);
+    a_cut[parts] = n;
+    b_cut[parts] = m;
+
+    for (std::size_t p = 1; p < parts; ++p) {
+        if (n >= m) {
+            a_cut[p] = n * p / parts;
+            b_cut[p] = static_cast<std::size_t>(branchless_lower_bound(b, m, a[a_cut[p]]) - b);
+        } else {
+            b_cut[p] = m * p / parts;
+            a_cut[p] = static_cast<std::size_t>(branchless_lower_bound(a, n, b[b_cut[p]]) - a);
+        }
+    }
+
+    std::vector<std::size_t> counts(parts, 0);
+
+    auto merge_part = [&](std::size_t p) {
+        counts[p] = kernel(a + a_cut[p], a_cut[p + 1] - a_cut[p], b + b_cut[p],
+                           b_cut[p + 1] - b_cut[p], out + offset(a_cut[p], b_cut[p]));
+    };
+
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(parts - 1);
+        for (std::size_t p = 1; p < parts; ++p)
+            threads.emplace_back(merge_part, p);
+
+        merge_part(0);  // on the calling thread
+    }  // join
+
+    // Concatenate the parts: each one is moved to the end of the previous one (offset(0, 0) == 0)
+    std::size_t k = counts[0];
+    for (std::size_t p = 1; p < parts; ++p) {
+        if (counts[p] > 0)
+            std::memmove(out + k, out + offset(a_cut[p], b_cut[p]), counts[p] * sizeof(T));
+        k += counts[p];
+    }
+
+    return k;
+}
+
+}  // namespace
+
+/*
+ * Values in both a[0, n) and b[0, m)
+ * The result of a part is never longer than the part of the shorter array
+ */
+template <MergeValue T>
+std::size_t parallel_sorted_intersection(const T* a, std::size_t n, const T* b, std::size_t m,
+                                         T* out, unsigned n_threads) {
+    const bool a_shorter = n <= m;
+
+    return merge_parts(a, n, b, m, out, n_threads, sorted_intersection<T>,
+                       [a_shorter](std::size_t i, std::size_t j) { return a_shorter ? i : j; });
+}
+
+/*
+ * Values in a[0, n) or in b[0, m)
+ * The result of a part is never longer than the two parts together
+ */
+template <MergeValue T>
+std::size_t parallel_sorted_union(const T* a, std::size_t n, const T* b, std::size_t m, T* out,
+                                  unsigned n_threads) {
+    return merge_parts(a, n, b, m, out, n_threads, sorted_union<T>,
+                       [](std::size_t i, std::size_t j) { return i + j; });
+}
+
+/*
+ * Values in a[0, n) that are not in b[0, m)
+ * The result of a part is never longer than the part of a
+ */
+template <MergeValue T>
+std::size_t parallel_sorted_difference(const T* a, std::size_t n, const T* b, std::size_t m,
+                                       T* out, unsigned n_threads) {
+    return merge_parts(a, n, b, m, out, n_threads, sorted_difference<T>,
+                       [](std::size_t i, std::size_t) { return i; });
+}
+
+template std::size_t parallel_sorted_intersection(const int*, std::size_t, const int*, std::size_t,
+                                                  int*, unsigned);
+template std::size_t parallel_sorted_union(const int*, std::size_t, const int*, std::size_t, int*,
+                                           unsigned);
+template std::size_t parallel_sorted_difference(const int*, std::size_t, const int*, std::size_t,
+                                                int*, unsigned);
+
+template std::size_t parallel_sorted_intersection(const std::int64_t*, std::size_t,
+                                                  const std::int64_t*, std::size_t, std::int64_t*,
+                                                  unsigned);
+template std::size_t parallel_sorted_union(const std::int64_t*, std::size_t, const std::int64_t*,
+                                           std::size_t, std::int64_t*, unsigned);
+template std::size_t parallel_sorted_difference(const std::int64_t*, std::size_t,
+                                                const std::int64_t*, std::size_t, std::int64_t*,
+                                                unsigned);
+
+template std::size_t parallel_sorted_intersection(const std::uint64_t*, std::size_t,
+                                                  const std::uint64_t*, std::size_t, std::uint64_t*,
+                                                  unsigned);
+template std::size_t parallel_sorted_union(const std::uint64_t*, std::size_t, const std::uint64_t*,
+                                           std::size_t, std::uint64_t*, unsigned);
+template std::size_t parallel_sorted_difference(const std::uint64_t*, std::size_t,
+                                                const std::uint64_t*, std::size_t, std::uint64_t*,
+                                                unsigned);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+#include "simd_merge.h"
+
+/*
+ * Parallel versions of the merge kernels of simd_merge.h, for large sorted arrays of unique values
+ *
+ * Both arrays are cut at the same values: pivot values are taken at evenly spaced positions of the
+ * longer array and located in the other array by binary search. Each pair of sub-arrays holds a
+ * separate range of values, so the pairs are merged on separate threads and the partial results
+ * are concatenated in order, without sorting
+ *
+ * n_threads == 0 means std::thread::hardware_concurrency()
+ * Arrays with fewer than parallel_min_size values in total are merged on the calling thread
+ * out must not overlap the input arrays
+ */
+
+/*
+ * Merges of fewer values (n + m) are not split
+ */
+inline constexpr std::size_t parallel_min_size = std::size_t{1} << 20;
+
+/*
+ * Values in both a[0, n) and b[0, m)
+ * out must have room for min(n, m) values
+ */
+template <MergeValue T>
+std::size_t parallel_sorted_intersection(const T* a, std::size_t n, const T* b, std::size_t m,
+                                         T* out, unsigned n_threads = 0);
+
+/*
+ * Values in a[0, n) or in b[0, m)
+ * out must have room for n + m values
+ */
+template <MergeValue T>
+std::size_t parallel_sorted_union(const T* a, std::size_t n, const T* b, std::size_t m, T* out,
+                                  unsigned n_threads = 0);
+
+/*
+ * Values in a[0, n) that are not in b[0, m)
+ * out must have room for n values
+ */
+template <MergeValue T>
+std::size_t parallel_sorted_difference(const T* a, std::size_t n, const T* b, std::size_t m,
+                                       T* out, unsigned n_threads = 0);
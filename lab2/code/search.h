@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/*
+ * Branchless binary search: return a pointer to the first element x of the sorted array
+ * [first, first + n) such that key(x) >= val, or first + n if there is no such element
+ * comp is the order of the array (std::less<> by default): key(x) >= val means !comp(key(x), val)
+ * The loop has no data-dependent branch (the compiler emits a conditional move) and always runs
+ * log2(n) iterations, so it does not suffer from branch mispredictions
+ */
+template <typename T, typename Key, typename Val, typename Compare>
+const T* branchless_lower_bound(const T* first, std::size_t n, const Val& val, Key key,
+                                Compare comp) {
+    if (n == 0)
+        return first;
+
+    const T* base = first;
+    while (n > 1) {
+        const std::size_t half = n / 2;
+        base = comp(key(base[half]), val) ? base + half : base;
+        n -= half;
+    }
+
+    return base + comp(key(*base), val);
+}
+
+template <typename T, typename Key, typename Val>
+const T* branchless_lower_bound(const T* first, std::size_t n, const Val& val, Key key) {
+    return branchless_lower_bound(first, n, val, key, std::less<>{});
+}
+
+template <typename T>
+const T* branchless_lower_bound(const T* first, std::size_t n, const T& val) {
+    return branchless_lower_bound(first, n, val, [](const T& x) -> const T& { return x; });
+}
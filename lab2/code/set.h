@@ -2,41 +2,63 @@
 
 #include <iostream>
 #include <vector>
+#include <span>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <compare>  // three-way comparison operator <=>
 
-/** Class to represent a Set of ints
+#include "set_file.h"
+#include "search.h"
+
+/** Class template to represent a Set of values of type T, ordered by Compare
  *
- * Set is implemented as a sorted doubly linked list
+ * BasicSet is implemented as a sorted doubly linked list
  * Sets should not contain repetitions, i.e.
- * two ints with the same value cannot belong to a Set
+ * two equivalent values (neither is ordered before the other by Compare) cannot belong to a Set
  *
  * All Set operations must have a linear time complexity, in the worst case
+ * Set (below) is BasicSet<int>; set_for.h selects a contiguous FlatSet for trivially copyable keys
  */
-class Set {
+template <typename T, typename Compare = std::less<T>>
+class BasicSet {
 
 public:
     /*
      *  Default constructor :create an empty Set
      */
-    Set();
+    BasicSet();
 
     /*
      *  Conversion constructor: convert val into a singleton {val}
      */
-    Set(int val);
+    BasicSet(const T& val);
 
     /*
-     * Constructor to create a Set from a sorted vector of unique ints
-     * Create a Set with all ints in sorted vector list_of_values
+     * Constructor to create a Set from a sorted vector of unique values
+     * Create a Set with all values in sorted vector list_of_values
      */
-    explicit Set(const std::vector<int>& list_of_values);
+    explicit BasicSet(const std::vector<T>& list_of_values);
 
     /*
      * Copy constructor: create a new Set as a copy of Set S
      * \param S Set to copied
      * Function does not modify Set S in any way
      */
-    Set(const Set& S);
+    BasicSet(const BasicSet& S);
+
+    /*
+     * Move constructor: create a new Set by taking over the Nodes of Set S
+     * No Node is created or copied, and S is left empty (without dummy nodes)
+     * An empty Set left by a move can still be used as any other Set
+     */
+    BasicSet(BasicSet&& S) noexcept;
 
     /*
      * Transform the Set into an empty set
@@ -47,21 +69,27 @@ public:
     /*
      * Destructor: deallocate all memory (Nodes) allocated for the list
      */
-    ~Set();
+    ~BasicSet();
 
     /*
      * Assignment operator: assign new contents to the *this Set, replacing its current content
      * \param S Set to be copied into Set *this
-     * Call by valued is used
      */
-    Set& operator=(Set S);
+    BasicSet& operator=(const BasicSet& S);
+
+    /*
+     * Move assignment operator: take over the Nodes of Set S, replacing the current content
+     * of the *this Set. S is left empty
+     */
+    BasicSet& operator=(BasicSet&& S) noexcept;
 
     /*
      * Test whether val belongs to the Set
      * Return true if val belongs to the set, otherwise false
      * This function does not modify the Set in any way
+     * O(log n) for Sets with an index, see build_index()
      */
-    bool is_member(int val) const;
+    bool is_member(const T& val) const;
 
     /*
      * Test whether the Set is empty
@@ -86,7 +114,7 @@ public:
      * Return true, if *this has same elemnts as set S
 	 * Return false, otherwise
      */
-    bool operator==(const Set& S) const;
+    bool operator==(const BasicSet& S) const;
 
     /*
      * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
@@ -95,25 +123,61 @@ public:
      * Return std::partial_ordering::greater, if *this > S (*this constains Set S)
      * Return std::partial_ordering::unordered, otherwise (Sets *this and S are not comparable)
      */
-    std::partial_ordering operator<=>(const Set& S) const;
+    std::partial_ordering operator<=>(const BasicSet& S) const;
+
+    /*
+     * Test whether Set *this and S have no common values
+     * Return true, if no value belongs to both sets
+     * Return false, otherwise
+     */
+    bool is_disjoint(const BasicSet& S) const;
 
     /*
      * Modify Set *this such that it becomes the union of *this with Set S
      * Set *this is modified and then returned
      */
-    Set& operator+=(const Set& S);
+    BasicSet& operator+=(const BasicSet& S);
 
     /*
      * Modify Set *this such that it becomes the intersection of *this with Set S
      * Set *this is modified and then returned
      */
-    Set& operator*=(const Set& S);
+    BasicSet& operator*=(const BasicSet& S);
 
     /*
      * Modify Set *this such that it becomes the Set difference between Set *this and Set S
      * Set *this is modified and then returned
      */
-    Set& operator-=(const Set& S);
+    BasicSet& operator-=(const BasicSet& S);
+
+    /*
+     * Union of all Sets in sets, in one K-way merge: a heap holds the smallest remaining value
+     * of each Set, so N values in total cost O(N log K) instead of K rewrites of the result
+     * The Nodes of the new Set are allocated in a single slab
+     */
+    static BasicSet union_all(std::span<const BasicSet* const> sets);
+
+    /*
+     * Intersection of all Sets in sets
+     * The values of the smallest Set are searched in the other Sets, which are not scanned:
+     * their positions move forward by exponential search on the index (galloping)
+     * The Nodes of the new Set are allocated in a single slab
+     */
+    static BasicSet intersect_all(std::span<const BasicSet* const> sets);
+
+    /*
+     * Write Set *this to stream os in the binary format of set_file.h (Sets of ints only)
+     * \param block_size values per block of the block table, 0 to write no block table
+     */
+    void write_binary(std::ostream& os, std::uint32_t block_size = default_block_size) const
+        requires std::same_as<T, int> && std::same_as<Compare, std::less<int>>;
+
+    /*
+     * Read a Set written by write_binary from stream is (Sets of ints only)
+     * If the data is not valid, the failbit of is is set and an empty Set is returned
+     */
+    static BasicSet read_binary(std::istream& is)
+        requires std::same_as<T, int> && std::same_as<Compare, std::less<int>>;
 
     /*
      * Return number of existing nodes
@@ -124,20 +188,77 @@ public:
 private:
     class Node;  // nested class defined in node.h
 
+    // Compare is std::less or std::greater: two values are equivalent if and only if they are
+    // equal, so == and std::hash can be used for the values
+    static constexpr bool standard_order =
+        std::same_as<Compare, std::less<T>> || std::same_as<Compare, std::greater<T>>;
+
     Node* head;      // pointer to the dummy header Node
     Node* tail;      // pointer to the dummy tail Node
     size_t counter;  // number of values in the Set
 
+    // Sparse index over the list: one entry for every index_stride-th Node, sorted by value
+    // It is a single express lane over the list, as in a skip list: is_member searches the
+    // entries and then walks at most index_stride - 1 Nodes
+    struct IndexEntry {
+        T value;
+        Node* node;
+    };
+
+    static constexpr size_t index_stride = 8;     // Nodes per index entry
+    static constexpr size_t index_min_size = 32;  // smaller Sets are just scanned
+
+    std::vector<IndexEntry> index;  // empty if the Set has no valid index
+
+    // Bloom-style fingerprint: bit fingerprint_bit(val) is set for every value val of the Set
+    // If A is a subset of B, then the bits of A are a subset of the bits of B, so most pairs of
+    // sets that are not comparable are told apart in O(1), together with the smallest and
+    // largest values (the first and last Nodes)
+    // insert_node sets the bit of the new value, remove_node cannot clear it (other values may
+    // share it), and build_index recomputes the fingerprint, so it is exact after every public
+    // member function
+    std::uint64_t fingerprint{0};
+
+    // Pool of the Nodes storing values (the dummy Nodes are allocated separately)
+    // Nodes are carved out of slabs owned by the Set, removed Nodes are kept in a free list
+    // for reuse, and make_empty releases all slabs at once instead of deleting Node by Node
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    static constexpr size_t min_slab_nodes = 4;
+    static constexpr size_t max_slab_nodes = 4096;
+
+    std::vector<std::unique_ptr<std::byte[]>> slabs;
+    size_t slab_capacity{0};        // number of Nodes in all slabs
+    std::byte* slab_next{nullptr};  // first never-used Node of the last slab
+    std::byte* slab_end{nullptr};   // end of the last slab
+    FreeSlot* free_slots{nullptr};  // removed Nodes, available for reuse
+
     /* ************************** *
      * Private Member Functions    *
      * **************************  */
 
+    /*
+     * Test whether a is ordered before b, and whether a and b are equivalent
+     */
+    static bool less(const T& a, const T& b) {
+        return Compare{}(a, b);
+    }
+
+    static bool equivalent(const T& a, const T& b) {
+        if constexpr (standard_order)
+            return a == b;
+        else
+            return !less(a, b) && !less(b, a);
+    }
+
     /*
      * Insert a new Node storing val after the Node pointed by p
      * \param p pointer to a Node
      * \param val value to be inserted  after position p
      */
-    void insert_node(Node* p, int val);
+    void insert_node(Node* p, const T& val);
 
     /*
      * Remove the Node pointed by p
@@ -145,6 +266,81 @@ private:
      */
     void remove_node(Node* p);
 
+    /*
+     * Rebuild the index and the fingerprint of the Set
+     * insert_node and remove_node invalidate the index, so every public member function that
+     * modifies the Set calls build_index before returning: one more linear pass
+     */
+    void build_index();
+
+    /*
+     * The fingerprint bit of value val: a Fibonacci hash of std::hash<T>
+     * Values without std::hash, or with an order of their own, set all bits: the fingerprint
+     * then never rules anything out
+     */
+    static std::uint64_t fingerprint_bit(const T& val) {
+        if constexpr (standard_order && std::is_default_constructible_v<std::hash<T>>) {
+            const auto h = static_cast<std::uint64_t>(std::hash<T>{}(val));
+            return std::uint64_t{1} << ((h * 0x9E3779B97F4A7C15u) >> 58);
+        } else {
+            return ~std::uint64_t{0};
+        }
+    }
+
+    /*
+     * Return the first Node with value >= val, at or after Node n
+     * entry is the position in the index of a Node at or before n, and it is moved forward
+     * Exponential search on the index from entry, then a walk of less than index_stride Nodes
+     */
+    Node* seek(Node* n, size_t& entry, const T& val) const;
+
+    /*
+     * O(1) test: return false if Set S is certainly not included in Set *this
+     * Both sets must not be empty
+     */
+    bool may_include(const BasicSet& S) const;
+
+    /*
+     * Test whether all values of Set S belong to Set *this
+     * Both sets must not be empty
+     */
+    bool includes(const BasicSet& S) const;
+
+    /*
+     * Set union, intersection, and difference of S1 and S2, merged into a new Set
+     * Used by operator+, operator*, and operator-
+     */
+    static BasicSet merge_union(const BasicSet& S1, const BasicSet& S2);
+    static BasicSet merge_intersection(const BasicSet& S1, const BasicSet& S2);
+    static BasicSet merge_difference(const BasicSet& S1, const BasicSet& S2);
+
+    /*
+     * Create a Node in the pool: reuse a removed Node, or take the next unused Node of the
+     * last slab, or allocate a new slab (twice as large as the pool, up to max_slab_nodes)
+     */
+    Node* new_node(const T& val, Node* nextPtr, Node* prevPtr);
+
+    /*
+     * Destroy Node p and keep its memory in the pool for reuse
+     */
+    void delete_node(Node* p);
+
+    /*
+     * Make sure that n Nodes can be created with no more than one allocation
+     */
+    void reserve_nodes(size_t n);
+
+    /*
+     * Destroy all Nodes storing values and free all slabs
+     * The list is not relinked, see make_empty
+     */
+    void release_nodes();
+
+    /*
+     * Exchange the contents (list, index, and pool) of Set *this and Set S
+     */
+    void swap(BasicSet& S) noexcept;
+
     /*
      * Write Set *this to stream os
      */
@@ -158,7 +354,7 @@ private:
      * Overloaded operator<<
      * \param os ostream object where the set S elements are written
      */
-    friend std::ostream& operator<<(std::ostream& os, const Set& S) {
+    friend std::ostream& operator<<(std::ostream& os, const BasicSet& S) {
         S.write_to_stream(os);
         return os;
     }
@@ -167,26 +363,1004 @@ private:
      * Overloaded operator+: Set union S1+S2
      * S1+S2 is the Set of elements in Set S1 or in Set S2 (without repeated elements)
      * Return a new Set representing the union of S1 with S2, S1+S2
+     * The new Set is built in one merge pass, S1 is not copied first
+     */
+    friend BasicSet operator+(const BasicSet& S1, const BasicSet& S2) {
+        return merge_union(S1, S2);
+    }
+
+    /*
+     * Overloaded operator+ for a temporary S1, e.g. S1+S2 in S1+S2+S3
+     * The union is computed in S1, so no Set is copied
      */
-    friend Set operator+(Set S1, const Set& S2) {
-        return (S1 += S2);
+    friend BasicSet operator+(BasicSet&& S1, const BasicSet& S2) {
+        S1 += S2;
+        return std::move(S1);
     }
 
     /*
      * Overloaded operator*: Set intersection S1*S2
      * S1*S2 is the Set of elements in both sets S1 and S2
      * Return a new Set representing the intersection of S1 with S2, S1*S2
+     * The new Set is built in one merge pass, S1 is not copied first
      */
-    friend Set operator*(Set S1, const Set& S2) {
-        return (S1 *= S2);
+    friend BasicSet operator*(const BasicSet& S1, const BasicSet& S2) {
+        return merge_intersection(S1, S2);
+    }
+
+    /*
+     * Overloaded operator* for a temporary S1
+     * The intersection is computed in S1, so no Set is copied
+     */
+    friend BasicSet operator*(BasicSet&& S1, const BasicSet& S2) {
+        S1 *= S2;
+        return std::move(S1);
     }
 
     /*
      * Overloaded operator-: Set difference S1-S2
      * S1-S2 is the Set of elements in Set S1 that do not belong to Set S2
      * Return a new Set representing the set difference S1-S2
+     * The new Set is built in one merge pass, S1 is not copied first
+     */
+    friend BasicSet operator-(const BasicSet& S1, const BasicSet& S2) {
+        return merge_difference(S1, S2);
+    }
+
+    /*
+     * Overloaded operator- for a temporary S1
+     * The difference is computed in S1, so no Set is copied
      */
-    friend Set operator-(Set S1, const Set& S2) {
-        return (S1 -= S2);
+    friend BasicSet operator-(BasicSet&& S1, const BasicSet& S2) {
+        S1 -= S2;
+        return std::move(S1);
+    }
+};
+
+#include "node.h"
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * Return number of existing nodes
+ */
+template <typename T, typename Compare>
+int BasicSet<T, Compare>::get_count_nodes() {
+    return Node::count_nodes;
+}
+
+/*
+ *  Default constructor :create an empty Set
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>::BasicSet() : counter{0} {
+    head = new Node(T{}, nullptr, nullptr);
+    tail = new Node(T{}, nullptr, head);
+    head->next = tail;
+}
+
+/*
+ *  Conversion constructor: convert val into a singleton {val}
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>::BasicSet(const T& val) : BasicSet{} {  // create an empty list
+    insert_node(head, val);
+}
+
+/*
+ * Constructor to create a Set from a sorted vector of unique values
+ * Create a Set with all values in sorted vector list_of_values
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>::BasicSet(const std::vector<T>& list_of_values)
+    : BasicSet{} {  // create an empty list
+    reserve_nodes(list_of_values.size());  // a single slab
+
+    Node* n = head;
+
+    for(int i = 0;i < std::ssize(list_of_values);i++)
+    {
+        insert_node(n, list_of_values[i]);
+        n = n->next;
+    }
+
+    build_index();
+}
+
+/*
+ * Copy constructor: create a new Set as a copy of Set S
+ * \param S Set to copied
+ * Function does not modify Set S in any way
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>::BasicSet(const BasicSet& S) : BasicSet{} {  // create an empty list
+    if (S.is_empty())
+        return;
+
+    reserve_nodes(S.counter);  // a single slab
+
+    Node* n_original = S.head;
+    Node* n_copy = head;
+
+    while(n_original->next != S.tail)
+    {
+        n_original = n_original->next;
+        insert_node(n_copy, n_original->value);
+        n_copy = n_copy->next;
+    }
+
+    build_index();
+}
+
+/*
+ * Move constructor: create a new Set by taking over the Nodes of Set S
+ * No Node is created or copied, and S is left empty (without dummy nodes)
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>::BasicSet(BasicSet&& S) noexcept
+    : head{std::exchange(S.head, nullptr)}
+    , tail{std::exchange(S.tail, nullptr)}
+    , counter{std::exchange(S.counter, 0)}
+    , index{std::move(S.index)}
+    , fingerprint{std::exchange(S.fingerprint, 0)}
+    , slabs{std::move(S.slabs)}
+    , slab_capacity{std::exchange(S.slab_capacity, 0)}
+    , slab_next{std::exchange(S.slab_next, nullptr)}
+    , slab_end{std::exchange(S.slab_end, nullptr)}
+    , free_slots{std::exchange(S.free_slots, nullptr)} {
+    S.index.clear();
+    S.slabs.clear();
+}
+
+/*
+ * Transform the Set into an empty set
+ * Remove all nodes from the list, except the dummy nodes
+ * The memory of the removed nodes is released slab by slab, not node by node
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::make_empty() {
+    if(is_empty())
+        return;
+
+    release_nodes();  // all slabs at once
+
+    head->next = tail;
+    tail->prev = head;
+}
+
+/*
+ * Destructor: deallocate all memory (Nodes) allocated for the list
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>::~BasicSet() {
+    make_empty();
+
+    delete head;
+    delete tail;
+}
+
+/*
+ * Assignment operator: assign new contents to the *this Set, replacing its current content
+ * \param S Set to be copied into Set *this
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>& BasicSet<T, Compare>::operator=(const BasicSet& S) {
+    if (this != &S)
+    {
+        BasicSet copy{S};
+        swap(copy);
+    }
+
+    return *this;
+}
+
+/*
+ * Move assignment operator: take over the Nodes of Set S, replacing the current content
+ * of the *this Set. S is left empty
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>& BasicSet<T, Compare>::operator=(BasicSet&& S) noexcept {
+    if (this != &S)
+    {
+        BasicSet old{std::move(S)};
+        swap(old);  // the current content is destroyed with old
+    }
+
+    return *this;
+}
+
+/*
+ * Test whether val belongs to the Set
+ * Return true if val belongs to the set, otherwise false
+ * This function does not modify the Set in any way
+ * O(log n) with the index: binary search the index, then walk less than index_stride Nodes
+ */
+template <typename T, typename Compare>
+bool BasicSet<T, Compare>::is_member(const T& val) const {
+    if (is_empty())  // a moved-from Set has no dummy nodes
+        return false;
+
+    // O(1) rejections: the fingerprint bit of val is not set, or val is out of range
+    if ((fingerprint & fingerprint_bit(val)) == 0 || less(val, head->next->value) ||
+        less(tail->prev->value, val))
+        return false;
+
+    Node* n = head->next;
+
+    if (!index.empty())
+    {
+        // First index entry with value >= val
+        const IndexEntry* first = index.data();
+        const IndexEntry* last = first + index.size();
+        const IndexEntry* e = branchless_lower_bound(
+            first, index.size(), val, [](const IndexEntry& x) -> const T& { return x.value; },
+            Compare{});
+
+        if (e != last && equivalent(e->value, val))
+            return true;
+
+        if (e == first)  // val is smaller than all values
+            return false;
+
+        n = (e - 1)->node->next;  // val can only be among the next index_stride - 1 Nodes
+    }
+
+    // The list is sorted: stop at the first value not smaller than val
+    while (n != tail && less(n->value, val))
+        n = n->next;
+
+    return n != tail && equivalent(n->value, val);
+}
+
+/*
+ * Test whether Set *this and S represent the same set
+ * Return true, if *this has same elemnts as set S
+ * Return false, otherwise
+ */
+template <typename T, typename Compare>
+bool BasicSet<T, Compare>::operator==(const BasicSet& S) const {
+    if(counter != S.counter)
+        return false;
+
+    if(is_empty())
+        return true;
+
+    // O(1) rejections: different fingerprints, smallest values, or largest values
+    if(fingerprint != S.fingerprint || !equivalent(head->next->value, S.head->next->value) ||
+       !equivalent(tail->prev->value, S.tail->prev->value))
+        return false;
+
+    Node* n_current = head;
+    Node* n_compare = S.head;
+
+    while(n_current != tail)
+    {
+        n_current = n_current->next;
+        n_compare = n_compare->next;
+
+        if(n_current != tail && !equivalent(n_current->value, n_compare->value))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
+ * Return std::partial_ordering::equivalent, if *this == S
+ * Return std::partial_ordering::less, if *this < S
+ * Return std::partial_ordering::greater, if *this > S
+ * Return std::partial_ordering::unordered, otherwise
+ */
+template <typename T, typename Compare>
+std::partial_ordering BasicSet<T, Compare>::operator<=>(const BasicSet& S) const {
+    // Sets with the same number of values are either equal or not comparable
+    if(counter == S.counter)
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+
+    if(is_empty())  // the empty set is contained in any set
+        return std::partial_ordering::less;
+
+    if(S.is_empty())
+        return std::partial_ordering::greater;
+
+    if(counter < S.counter)
+        return (S.may_include(*this) && S.includes(*this)) ? std::partial_ordering::less
+                                                           : std::partial_ordering::unordered;
+
+    return (may_include(S) && includes(S)) ? std::partial_ordering::greater
+                                           : std::partial_ordering::unordered;
+}
+
+/*
+ * Test whether Set *this and S have no common values
+ * Return true, if no value belongs to both sets
+ * Return false, otherwise
+ */
+template <typename T, typename Compare>
+bool BasicSet<T, Compare>::is_disjoint(const BasicSet& S) const {
+    if(is_empty() || S.is_empty())
+        return true;
+
+    // O(1) answers: no common fingerprint bit, or value ranges that do not overlap
+    if((fingerprint & S.fingerprint) == 0 || less(tail->prev->value, S.head->next->value) ||
+       less(S.tail->prev->value, head->next->value))
+        return true;
+
+    Node* n_current = head->next;
+    Node* n_other = S.head->next;
+
+    while(n_current != tail && n_other != S.tail)
+    {
+        if(less(n_current->value, n_other->value))
+            n_current = n_current->next;
+        else if(less(n_other->value, n_current->value))
+            n_other = n_other->next;
+        else
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Modify Set *this such that it becomes the union of *this with Set S
+ * Set *this is modified and then returned
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>& BasicSet<T, Compare>::operator+=(const BasicSet& S) {
+    if(S.is_empty())
+        return *this;
+
+    if(is_empty())
+        return *this = S;
+
+    Node* n_current = head->next;
+    Node* n_other = S.head->next;
+
+    while(n_other != S.tail)
+    {
+        if(n_current == tail)
+        {
+            insert_node(n_current->prev, n_other->value);
+            n_other = n_other->next;
+        }
+        else if(less(n_current->value, n_other->value))
+        {
+            n_current = n_current->next;
+        }
+        else if(less(n_other->value, n_current->value))
+        {
+            insert_node(n_current->prev, n_other->value);
+            n_other = n_other->next;
+        }
+        else
+        {
+            n_current = n_current->next;
+            n_other = n_other->next;
+        }
+    }
+
+    build_index();
+    return *this;
+}
+
+/*
+ * Modify Set *this such that it becomes the intersection of *this with Set S
+ * Set *this is modified and then returned
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>& BasicSet<T, Compare>::operator*=(const BasicSet& S) {
+    if(is_empty())  // a moved-from Set has no dummy nodes
+        return *this;
+
+    if(S.is_empty())
+    {
+        make_empty();
+        return *this;
+    }
+
+    Node* n_current = head->next;
+    Node* n_other = S.head->next;
+
+    while(n_current != tail && n_other != S.tail)
+    {
+        if(less(n_current->value, n_other->value))
+        {
+            n_current = n_current->next;
+            remove_node(n_current->prev);
+        }
+        else if(less(n_other->value, n_current->value))
+        {
+            n_other = n_other->next;
+        }
+        else
+        {
+            n_current = n_current->next;
+            n_other = n_other->next;
+        }
+    }
+
+    while(n_current != tail)
+    {
+        n_current = n_current->next;
+        remove_node(n_current->prev);
+    }
+
+    build_index();
+    return *this;
+}
+
+/*
+ * Modify Set *this such that it becomes the Set difference between Set *this and Set S
+ * Set *this is modified and then returned
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare>& BasicSet<T, Compare>::operator-=(const BasicSet& S) {
+    if(is_empty() || S.is_empty())
+        return *this;
+
+    Node* n_current = head->next;
+    Node* n_other = S.head->next;
+
+    while(n_current != tail && n_other != S.tail)
+    {
+        if(less(n_current->value, n_other->value))
+        {
+            n_current = n_current->next;
+        }
+        else if(less(n_other->value, n_current->value))
+        {
+            n_other = n_other->next;
+        }
+        else
+        {
+            n_current = n_current->next;
+            n_other = n_other->next;
+            remove_node(n_current->prev);
+        }
+    }
+
+    build_index();
+    return *this;
+}
+
+/*
+ * Union of all Sets in sets, in one K-way merge
+ * The first slab has the size of the largest Set, a lower bound of the result: the sum of the sizes
+ * is an upper bound, but up to K times the result for Sets that overlap a lot, e.g. posting lists.
+ * The slabs that follow grow as in new_node
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare> BasicSet<T, Compare>::union_all(std::span<const BasicSet* const> sets) {
+    // Smallest value not merged yet of a Set
+    struct Cursor {
+        T value;
+        Node* node;
+        const BasicSet* set;
+    };
+
+    auto greater = [](const Cursor& x, const Cursor& y) { return less(y.value, x.value); };
+
+    std::vector<Cursor> heap;  // min-heap
+    heap.reserve(sets.size());
+    size_t largest = 0;
+
+    for (const BasicSet* S : sets)
+    {
+        if (S->is_empty())
+            continue;
+
+        heap.push_back(Cursor{S->head->next->value, S->head->next, S});
+        largest = std::max(largest, S->counter);
+    }
+
+    std::ranges::make_heap(heap, greater);
+
+    BasicSet R;
+    R.reserve_nodes(largest);
+
+    while (!heap.empty())
+    {
+        std::ranges::pop_heap(heap, greater);
+        Cursor& c = heap.back();
+
+        // skip repeated values
+        if (R.is_empty() || !equivalent(R.tail->prev->value, c.value))
+            R.insert_node(R.tail->prev, c.value);
+
+        c.node = c.node->next;
+        if (c.node == c.set->tail)
+        {
+            heap.pop_back();
+        }
+        else
+        {
+            c.value = c.node->value;
+            std::ranges::push_heap(heap, greater);
+        }
+    }
+
+    R.build_index();
+    return R;
+}
+
+/*
+ * Intersection of all Sets in sets
+ * The values of the smallest Set are searched in the other Sets, from the smallest to the largest,
+ * so that most values are rejected by the first searches
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare> BasicSet<T, Compare>::intersect_all(std::span<const BasicSet* const> sets) {
+    BasicSet R;
+
+    if (sets.empty())
+        return R;
+
+    std::vector<const BasicSet*> order(std::begin(sets), std::end(sets));
+    std::ranges::sort(order, {}, [](const BasicSet* S) { return S->counter; });
+
+    // O(1) answer: an empty Set, or no fingerprint bit common to all Sets
+    std::uint64_t common = ~std::uint64_t{0};
+    for (const BasicSet* S : order)
+        common &= S->fingerprint;
+
+    if (order.front()->is_empty() || common == 0)
+        return R;
+
+    // Position in each of the other Sets
+    struct Cursor {
+        const BasicSet* set;
+        Node* node;
+        size_t entry;
+    };
+
+    std::vector<Cursor> cursors;
+    cursors.reserve(order.size() - 1);
+    for (size_t k = 1; k < order.size(); ++k)
+        cursors.push_back(Cursor{order[k], order[k]->head->next, 0});
+
+    const BasicSet* smallest = order.front();
+    R.reserve_nodes(smallest->counter);
+
+    for (Node* n = smallest->head->next; n != smallest->tail; n = n->next)
+    {
+        const T& val = n->value;
+        bool in_all = true;
+
+        for (Cursor& c : cursors)
+        {
+            c.node = c.set->seek(c.node, c.entry, val);
+
+            if (c.node == c.set->tail)  // no more common values
+            {
+                R.build_index();
+                return R;
+            }
+
+            if (!equivalent(c.node->value, val))
+            {
+                in_all = false;
+                break;
+            }
+        }
+
+        if (in_all)
+            R.insert_node(R.tail->prev, val);
+    }
+
+    R.build_index();
+    return R;
+}
+
+/*
+ * Write Set *this to stream os in the binary format of set_file.h
+ * The values are copied to a vector first, the encoder needs them in contiguous memory
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::write_binary(std::ostream& os, std::uint32_t block_size) const
+    requires std::same_as<T, int> && std::same_as<Compare, std::less<int>>
+{
+    std::vector<int> V;
+    V.reserve(counter);
+
+    if (!is_empty()) {  // a moved-from Set has no dummy nodes
+        for (Node* n = head->next; n != tail; n = n->next)
+            V.push_back(n->value);
+    }
+
+    write_sorted_values(os, V.data(), V.size(), block_size);
+}
+
+/*
+ * Read a Set written by write_binary from stream is
+ * The Nodes are allocated in a single slab
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare> BasicSet<T, Compare>::read_binary(std::istream& is)
+    requires std::same_as<T, int> && std::same_as<Compare, std::less<int>>
+{
+    return BasicSet{read_sorted_values(is)};
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Insert a new Node storing val after the Node pointed by p
+ * \param p pointer to a Node
+ * \param val value to be inserted  after position p
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::insert_node(Node* p, const T& val) {
+    Node* n = new_node(val, p->next, p);
+    p->next = p->next->prev = n;
+    counter++;
+    index.clear();  // may be out of date
+    fingerprint |= fingerprint_bit(val);
+}
+
+/*
+ * Remove the Node pointed by p
+ * \param p pointer to a Node
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::remove_node(Node* p) {
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+    delete_node(p);
+    counter--;
+    index.clear();  // may point to the deleted Node
+}
+
+/*
+ * Rebuild the index and the fingerprint of the Set
+ * One index entry for every index_stride-th Node, starting with the first Node
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::build_index() {
+    index.clear();
+    fingerprint = 0;
+
+    if (is_empty())
+        return;
+
+    if (counter < index_min_size)
+    {
+        for (Node* n = head->next; n != tail; n = n->next)
+            fingerprint |= fingerprint_bit(n->value);
+        return;
+    }
+
+    index.reserve((counter + index_stride - 1) / index_stride);
+
+    size_t i = 0;
+    for (Node* n = head->next; n != tail; n = n->next, ++i)
+    {
+        fingerprint |= fingerprint_bit(n->value);
+
+        if (i % index_stride == 0)
+            index.push_back(IndexEntry{n->value, n});
+    }
+}
+
+/*
+ * Return the first Node with value >= val, at or after Node n
+ * entry is the position in the index of a Node at or before n, and it is moved forward
+ */
+template <typename T, typename Compare>
+auto BasicSet<T, Compare>::seek(Node* n, size_t& entry, const T& val) const -> Node* {
+    if (n == tail || !less(n->value, val))
+        return n;
+
+    if (!index.empty())
+    {
+        // index[entry].value <= n->value < val: gallop to the last entry with value < val
+        size_t lo = entry;
+        size_t step = 1;
+        while (lo + step < index.size() && less(index[lo + step].value, val))
+        {
+            lo += step;
+            step *= 2;
+        }
+
+        const size_t hi = std::min(lo + step, index.size());  // index[hi].value >= val, if any
+        const IndexEntry* e = branchless_lower_bound(
+            index.data() + lo + 1, hi - lo - 1, val,
+            [](const IndexEntry& x) -> const T& { return x.value; }, Compare{});
+        entry = static_cast<size_t>(e - index.data()) - 1;
+
+        if (less(n->value, index[entry].value))
+            n = index[entry].node;
+    }
+
+    while (n != tail && less(n->value, val))
+        n = n->next;
+
+    return n;
+}
+
+/*
+ * O(1) test: return false if Set S is certainly not included in Set *this
+ * S has a fingerprint bit that *this does not have, or a value out of the range of *this
+ */
+template <typename T, typename Compare>
+bool BasicSet<T, Compare>::may_include(const BasicSet& S) const {
+    return (S.fingerprint & ~fingerprint) == 0 && !less(S.head->next->value, head->next->value) &&
+           !less(tail->prev->value, S.tail->prev->value);
+}
+
+/*
+ * Test whether all values of Set S belong to Set *this
+ * One merge pass, that stops at the first value of S not in *this
+ */
+template <typename T, typename Compare>
+bool BasicSet<T, Compare>::includes(const BasicSet& S) const {
+    Node* n_current = head->next;
+
+    for(Node* n_other = S.head->next; n_other != S.tail; n_other = n_other->next)
+    {
+        while(n_current != tail && less(n_current->value, n_other->value))
+            n_current = n_current->next;
+
+        if(n_current == tail || !equivalent(n_current->value, n_other->value))
+            return false;
+
+        n_current = n_current->next;
+    }
+
+    return true;
+}
+
+/*
+ * Set union S1+S2, built in one merge pass into a new Set
+ * The Nodes of the new Set are allocated in a single slab
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare> BasicSet<T, Compare>::merge_union(const BasicSet& S1, const BasicSet& S2) {
+    if (S1.is_empty())
+        return S2;
+
+    if (S2.is_empty())
+        return S1;
+
+    BasicSet R;
+    R.reserve_nodes(S1.counter + S2.counter);
+
+    Node* n1 = S1.head->next;
+    Node* n2 = S2.head->next;
+
+    while (n1 != S1.tail && n2 != S2.tail)
+    {
+        if (less(n1->value, n2->value))
+        {
+            R.insert_node(R.tail->prev, n1->value);
+            n1 = n1->next;
+        }
+        else if (less(n2->value, n1->value))
+        {
+            R.insert_node(R.tail->prev, n2->value);
+            n2 = n2->next;
+        }
+        else
+        {
+            R.insert_node(R.tail->prev, n1->value);
+            n1 = n1->next;
+            n2 = n2->next;
+        }
+    }
+
+    for (; n1 != S1.tail; n1 = n1->next)
+        R.insert_node(R.tail->prev, n1->value);
+
+    for (; n2 != S2.tail; n2 = n2->next)
+        R.insert_node(R.tail->prev, n2->value);
+
+    R.build_index();
+    return R;
+}
+
+/*
+ * Set intersection S1*S2, built in one merge pass into a new Set
+ * The Nodes of the new Set are allocated in a single slab
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare> BasicSet<T, Compare>::merge_intersection(const BasicSet& S1,
+                                                              const BasicSet& S2) {
+    BasicSet R;
+
+    if (S1.is_empty() || S2.is_empty())
+        return R;
+
+    R.reserve_nodes(std::min(S1.counter, S2.counter));
+
+    Node* n1 = S1.head->next;
+    Node* n2 = S2.head->next;
+
+    while (n1 != S1.tail && n2 != S2.tail)
+    {
+        if (less(n1->value, n2->value))
+        {
+            n1 = n1->next;
+        }
+        else if (less(n2->value, n1->value))
+        {
+            n2 = n2->next;
+        }
+        else
+        {
+            R.insert_node(R.tail->prev, n1->value);
+            n1 = n1->next;
+            n2 = n2->next;
+        }
+    }
+
+    R.build_index();
+    return R;
+}
+
+/*
+ * Set difference S1-S2, built in one merge pass into a new Set
+ * The Nodes of the new Set are allocated in a single slab
+ */
+template <typename T, typename Compare>
+BasicSet<T, Compare> BasicSet<T, Compare>::merge_difference(const BasicSet& S1,
+                                                            const BasicSet& S2) {
+    if (S1.is_empty() || S2.is_empty())
+        return S1;
+
+    BasicSet R;
+    R.reserve_nodes(S1.counter);
+
+    Node* n1 = S1.head->next;
+    Node* n2 = S2.head->next;
+
+    while (n1 != S1.tail && n2 != S2.tail)
+    {
+        if (less(n1->value, n2->value))
+        {
+            R.insert_node(R.tail->prev, n1->value);
+            n1 = n1->next;
+        }
+        else if (less(n2->value, n1->value))
+        {
+            n2 = n2->next;
+        }
+        else
+        {
+            n1 = n1->next;
+            n2 = n2->next;
+        }
     }
-};
\ No newline at end of file
+
+    for (; n1 != S1.tail; n1 = n1->next)
+        R.insert_node(R.tail->prev, n1->value);
+
+    R.build_index();
+    return R;
+}
+
+/*
+ * Create a Node in the pool: reuse a removed Node, or take the next unused Node of the
+ * last slab, or allocate a new slab (twice as large as the pool, up to max_slab_nodes)
+ */
+template <typename T, typename Compare>
+auto BasicSet<T, Compare>::new_node(const T& val, Node* nextPtr, Node* prevPtr) -> Node* {
+    void* mem;
+
+    if (free_slots != nullptr)
+    {
+        mem = free_slots;
+        free_slots = free_slots->next;
+    }
+    else
+    {
+        if (slab_next == slab_end)
+            reserve_nodes(std::clamp(slab_capacity, min_slab_nodes, max_slab_nodes));
+
+        mem = slab_next;
+        slab_next += sizeof(Node);
+    }
+
+    return ::new (mem) Node(val, nextPtr, prevPtr);
+}
+
+/*
+ * Destroy Node p and keep its memory in the pool for reuse
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::delete_node(Node* p) {
+    p->~Node();  // updates count_nodes
+    free_slots = ::new (static_cast<void*>(p)) FreeSlot{free_slots};
+}
+
+/*
+ * Make sure that n Nodes can be created with no more than one allocation
+ * The rest of the last slab is abandoned if a new slab is needed
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::reserve_nodes(size_t n) {
+    static_assert(sizeof(Node) >= sizeof(FreeSlot) && alignof(Node) >= alignof(FreeSlot));
+    static_assert(alignof(Node) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);  // alignment of the slabs
+
+    if (static_cast<size_t>(slab_end - slab_next) >= n * sizeof(Node))
+        return;
+
+    slabs.push_back(std::make_unique_for_overwrite<std::byte[]>(n * sizeof(Node)));
+    slab_next = slabs.back().get();
+    slab_end = slab_next + n * sizeof(Node);
+    slab_capacity += n;
+}
+
+/*
+ * Destroy all Nodes storing values and free all slabs
+ * If T has nothing to release, then instead of calling the destructor of every Node
+ * the number of existing nodes is updated once
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::release_nodes() {
+    if constexpr (std::is_trivially_destructible_v<T>) {
+        Node::count_nodes -= static_cast<int>(counter);
+        assert(Node::count_nodes >= 0);
+    } else {
+        for (Node* n = head->next; n != tail;)
+        {
+            Node* next = n->next;
+            n->~Node();  // updates count_nodes
+            n = next;
+        }
+    }
+
+    slabs.clear();
+    slab_capacity = 0;
+    slab_next = slab_end = nullptr;
+    free_slots = nullptr;
+
+    counter = 0;
+    index.clear();
+    fingerprint = 0;
+}
+
+/*
+ * Exchange the contents (list, index, and pool) of Set *this and Set S
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::swap(BasicSet& S) noexcept {
+    std::swap(head, S.head);
+    std::swap(tail, S.tail);
+    std::swap(counter, S.counter);
+    std::swap(index, S.index);
+    std::swap(fingerprint, S.fingerprint);
+    std::swap(slabs, S.slabs);
+    std::swap(slab_capacity, S.slab_capacity);
+    std::swap(slab_next, S.slab_next);
+    std::swap(slab_end, S.slab_end);
+    std::swap(free_slots, S.free_slots);
+}
+
+/*
+ * Write Set *this to stream os
+ */
+template <typename T, typename Compare>
+void BasicSet<T, Compare>::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        Node* ptr{head->next};
+
+        os << "{ ";
+        while (ptr != tail) {
+            os << ptr->value << " ";
+            ptr = ptr->next;
+        }
+        os << "}";
+    }
+}
+
+// The Set of ints is compiled once, in set.cpp
+extern template class BasicSet<int>;
+
+using Set = BasicSet<int>;
@@ -0,0 +1,461 @@
+#include "set_file.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::size_t header_size = 32;
+constexpr std::size_t entry_size = 16;  // one entry of the block table
+constexpr std::uint32_t magic = 0x53444E54;  // "TNDS"
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t sign_bit = 0x80000000u;
+
+/*
+ * Values are encoded as unsigned keys, value - INT_MIN, in the same order as the values
+ */
+std::uint32_t key_of(int val) {
+    return static_cast<std::uint32_t>(val) ^ sign_bit;
+}
+
+int value_of(std::uint32_t key) {
+    return static_cast<int>(key ^ sign_bit);
+}
+
+/*
+ * Little-endian stores and loads
+ */
+void put_u32(unsigned char* p, std::uint32_t x) {
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<unsigned char>(x >> (8 * i));
+}
+
+void put_u64(unsigned char* p, std::uint64_t x) {
+    for (int i = 0; i < 8; ++i)
+        p[i] = static_cast<unsigned char>(x >> (8 * i));
+}
+
+std::uint32_t get_u32(const std::byte* p) {
+    std::uint32_t x = 0;
+    for (int i = 0; i < 4; ++i)
+        x |= std::to_integer<std::uint32_t>(p[i]) << (8 * i);
+    return x;
+}
+
+std::uint64_t get_u64(const std::byte* p) {
+    std::uint64_t x = 0;
+    for (int i = 0; i < 8; ++i)
+        x |= std::to_integer<std::uint64_t>(p[i]) << (8 * i);
+    return x;
+}
+
+void put_varint(std::vector<unsigned char>& out, std::uint32_t x) {
+    while (x >= 0x80) {
+        out.push_back(static_cast<unsigned char>(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(x));
+}
+
+[[noreturn]] void invalid_data() {
+    throw std::runtime_error{"invalid set data"};
+}
+
+/*
+ * Read the varint at p, which must end before end, and advance p past it
+ */
+std::uint32_t get_varint(const std::byte*& p, const std::byte* end) {
+    // Fast path: deltas of dense sets fit in one byte
+    if (p != end && std::to_integer<unsigned>(*p) < 0x80)
+        return std::to_integer<std::uint32_t>(*p++);
+
+    std::uint32_t x = 0;
+    for (int shift = 0;; shift += 7) {
+        if (p == end)
+            invalid_data();
+
+        const auto b = std::to_integer<std::uint32_t>(*p++);
+        if (shift == 28 && b > 0x0F)  // more than 32 bits
+            invalid_data();
+
+        x |= (b & 0x7F) << shift;
+        if (b < 0x80)
+            return x;
+    }
+}
+
+struct Header {
+    std::uint64_t counter;
+    std::uint32_t block_size;
+    std::uint32_t n_blocks;
+    std::uint64_t data_size;
+
+    /*
+     * Size of the block table, at most 2^36: it cannot wrap around
+     */
+    std::uint64_t table_size() const {
+        return std::uint64_t{n_blocks} * entry_size;
+    }
+
+    /*
+     * Size of the record without the header
+     * read_header makes sure that the sum cannot wrap around
+     */
+    std::uint64_t body_size() const {
+        return table_size() + data_size;
+    }
+
+    /*
+     * Test whether the body of the record fits in the given number of bytes
+     * The sizes are compared one at a time, so that no sum can wrap around
+     */
+    bool body_fits(std::uint64_t available) const {
+        return table_size() <= available && data_size <= available - table_size();
+    }
+};
+
+/*
+ * Read and check the header at p (header_size bytes)
+ */
+Header read_header(const std::byte* p) {
+    if (get_u32(p) != magic || get_u32(p + 4) != version)
+        invalid_data();
+
+    const Header h{get_u64(p + 8), get_u32(p + 16), get_u32(p + 20), get_u64(p + 24)};
+
+    // Every value takes at least one byte of data, and there is one block per block_size values
+    const std::uint64_t n_blocks =
+        (h.block_size == 0) ? 0 : h.counter / h.block_size + (h.counter % h.block_size != 0);
+
+    if (h.counter > h.data_size || h.n_blocks != n_blocks)
+        invalid_data();
+
+    // The whole record must be addressable, e.g. a data_size close to 2^64 would wrap body_size
+    if (!h.body_fits(std::numeric_limits<std::size_t>::max() - header_size))
+        invalid_data();
+
+    return h;
+}
+
+}  // namespace
+
+/*
+ * Write the sorted unique ints V[0, n) to stream os as one record
+ */
+void write_sorted_values(std::ostream& os, const int* V, std::size_t n, std::uint32_t block_size) {
+    const std::size_t stride = (block_size == 0) ? std::max<std::size_t>(n, 1) : block_size;
+    const std::size_t n_blocks = (block_size == 0) ? 0 : (n + stride - 1) / stride;
+
+    std::vector<unsigned char> table(n_blocks * entry_size);
+    std::vector<unsigned char> data;
+    data.reserve(n + n / 4);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % stride == 0) {  // first value of a block
+            if (n_blocks > 0) {
+                unsigned char* entry = table.data() + (i / stride) * entry_size;
+                put_u32(entry, static_cast<std::uint32_t>(V[i]));
+                put_u32(entry + 4, 0);
+                put_u64(entry + 8, data.size());
+            }
+            put_varint(data, key_of(V[i]));
+        } else {
+            put_varint(data, key_of(V[i]) - key_of(V[i - 1]));
+        }
+    }
+
+    unsigned char header[header_size];
+    put_u32(header, magic);
+    put_u32(header + 4, version);
+    put_u64(header + 8, n);
+    put_u32(header + 16, block_size);
+    put_u32(header + 20, static_cast<std::uint32_t>(n_blocks));
+    put_u64(header + 24, data.size());
+
+    os.write(reinterpret_cast<const char*>(header), header_size);
+    os.write(reinterpret_cast<const char*>(table.data()), std::ssize(table));
+    os.write(reinterpret_cast<const char*>(data.data()), std::ssize(data));
+}
+
+/*
+ * Read one record from stream is and return its values, sorted
+ * The record is read in pieces of at most 1 MiB, so that a corrupt size fails at the end of the
+ * stream instead of allocating it all
+ */
+std::vector<int> read_sorted_values(std::istream& is) {
+    constexpr std::size_t piece = std::size_t{1} << 20;
+
+    std::vector<std::byte> record(header_size);
+
+    try {
+        if (!is.read(reinterpret_cast<char*>(record.data()), header_size))
+            invalid_data();
+
+        const std::uint64_t body = read_header(record.data()).body_size();
+
+        for (std::uint64_t done = 0; done < body;) {
+            const auto k = static_cast<std::size_t>(std::min<std::uint64_t>(body - done, piece));
+            record.resize(record.size() + k);
+            if (!is.read(reinterpret_cast<char*>(record.data() + header_size + done),
+                         static_cast<std::streamsize>(k)))
+                invalid_data();
+            done += k;
+        }
+
+        return SetView{record}.values();
+    } catch (const std::runtime_error&) {
+        is.setstate(std::ios_base::failbit);
+        return {};
+    }
+}
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * View of the record at the start of bytes
+ */
+SetView::SetView(std::span<const std::byte> bytes) {
+    if (bytes.size() < header_size)
+        invalid_data();
+
+    const Header h = read_header(bytes.data());
+    if (!h.body_fits(bytes.size() - header_size))
+        invalid_data();
+
+    record = bytes.first(header_size + static_cast<std::size_t>(h.body_size()));
+    table = record.subspan(header_size, std::size_t{h.n_blocks} * entry_size);
+    data = record.subspan(header_size + table.size());
+    counter = static_cast<std::size_t>(h.counter);
+    block_size = (h.block_size == 0) ? std::max<std::size_t>(counter, 1) : h.block_size;
+}
+
+/*
+ * Test whether val belongs to the set
+ */
+bool SetView::is_member(int val) const {
+    if (counter == 0)
+        return false;
+
+    const std::byte* p = data.data();
+    std::size_t block = 0;
+
+    if (!table.empty()) {
+        // Last block whose first value is not larger than val (branchless binary search)
+        auto first_of = [this](std::size_t k) {
+            return static_cast<int>(get_u32(table.data() + k * entry_size));
+        };
+
+        std::size_t n = table.size() / entry_size;
+        while (n > 1) {
+            const std::size_t half = n / 2;
+            block = (first_of(block + half) <= val) ? block + half : block;
+            n -= half;
+        }
+
+        if (first_of(block) > val)
+            return false;
+
+        const std::uint64_t offset = get_u64(table.data() + block * entry_size + 8);
+        if (offset >= data.size())
+            invalid_data();
+        p += offset;
+    }
+
+    bool found = false;
+    decode_block(p, block * block_size, [val, &found](int x) {
+        found = (x == val);
+        return x < val;
+    });
+
+    return found;
+}
+
+/*
+ * All values, in increasing order
+ * The whole record is checked: the values must be increasing and agree with the block table
+ */
+std::vector<int> SetView::values() const {
+    std::vector<int> V;
+    V.reserve(counter);  // counter <= data.size(): every value takes at least one byte
+
+    const std::byte* p = data.data();
+    for (std::size_t i = 0; i < counter; i += block_size) {
+        const std::byte* entry =
+            table.empty() ? nullptr : table.data() + (i / block_size) * entry_size;
+
+        if (entry && get_u64(entry + 8) != static_cast<std::uint64_t>(p - data.data()))
+            invalid_data();
+
+        p = decode_block(p, i, [&V](int x) {
+            V.push_back(x);
+            return true;
+        });
+
+        if (i > 0 && V[i] <= V[i - 1])  // blocks out of order
+            invalid_data();
+
+        if (entry && get_u32(entry) != static_cast<std::uint32_t>(V[i]))
+            invalid_data();
+    }
+
+    if (p != data.data() + data.size())
+        invalid_data();
+
+    return V;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Decode the block starting at p, whose first value is the index-th value of the set
+ */
+template <typename F>
+const std::byte* SetView::decode_block(const std::byte* p, std::size_t index, F f) const {
+    const std::byte* end = data.data() + data.size();
+    const std::size_t last = std::min(counter, index + block_size);
+
+    std::uint32_t key = get_varint(p, end);
+    while (true) {
+        if (!f(value_of(key)))
+            return nullptr;
+
+        if (++index == last)
+            return p;
+
+        const std::uint32_t delta = get_varint(p, end);
+        if (delta == 0 || key + delta < key)  // not increasing
+            invalid_data();
+        key += delta;
+    }
+}
+
+/*
+ * Write the set to stream os, as Set::write_to_stream
+ */
+void SetView::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        const std::byte* p = data.data();
+        for (std::size_t i = 0; i < counter; i += block_size) {
+            p = decode_block(p, i, [&os](int x) {
+                os << x << " ";
+                return true;
+            });
+        }
+        os << "}";
+    }
+}
+
+/*****************************************************
+ * MappedSetFile                                      *
+ ******************************************************/
+
+#ifdef _WIN32
+
+MappedSetFile::MappedSetFile(const std::string& path) {
+    auto fail = [&path] {
+        throw std::system_error{static_cast<int>(GetLastError()), std::system_category(), path};
+    };
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        fail();
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        fail();
+    }
+
+    length = static_cast<std::size_t>(size.QuadPart);
+    if (length > 0) {  // an empty file cannot be mapped
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* p = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (mapping)
+            CloseHandle(mapping);  // the view keeps the mapping alive
+
+        if (!p) {
+            CloseHandle(file);
+            fail();
+        }
+        begin = static_cast<const std::byte*>(p);
+    }
+
+    CloseHandle(file);
+}
+
+MappedSetFile::~MappedSetFile() {
+    if (begin)
+        UnmapViewOfFile(begin);
+}
+
+#else
+
+MappedSetFile::MappedSetFile(const std::string& path) {
+    auto fail = [&path](int fd) {
+        const int e = errno;
+        if (fd >= 0)
+            ::close(fd);
+        throw std::system_error{e, std::generic_category(), path};
+    };
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        fail(fd);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+        fail(fd);
+
+    length = static_cast<std::size_t>(st.st_size);
+    if (length > 0) {  // an empty file cannot be mapped
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+            fail(fd);
+        begin = static_cast<const std::byte*>(p);
+    }
+
+    ::close(fd);  // the mapping stays valid
+}
+
+MappedSetFile::~MappedSetFile() {
+    if (begin)
+        ::munmap(const_cast<std::byte*>(begin), length);
+}
+
+#endif
+
+/*
+ * Views of all records of the file, in order
+ */
+std::vector<SetView> MappedSetFile::sets() const {
+    std::vector<SetView> S;
+
+    for (auto rest = bytes(); !rest.empty();) {
+        S.emplace_back(rest);
+        rest = rest.subspan(S.back().size_bytes());
+    }
+
+    return S;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <span>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Binary format for sets of ints, used by Set::write_binary / Set::read_binary (and FlatSet)
+ *
+ * The values are stored sorted, as the differences between consecutive values (deltas) written as
+ * varints (7 bits per byte, the high bit tells that more bytes follow): dense sets take about one
+ * byte per value. The values are split in blocks of block_size values, and the first value of a
+ * block is stored whole, so decoding can start at any block
+ *
+ * A record is a header, a block table, and the varint data. All integers are little-endian
+ *
+ *   header (32 bytes)  magic "TNDS", version, number of values, block_size, number of blocks in
+ *                      the table, size of the data in bytes
+ *                      block_size 0 means no block table: the whole set is then a single block
+ *   block table        for each block: first value (4 bytes), unused (4 bytes), offset of the
+ *                      block in the data (8 bytes)
+ *   data               for each value: varint(value - previous value), or varint(value - INT_MIN)
+ *                      for the first value of a block
+ *
+ * With the block table, is_member binary searches the table and decodes a single block
+ * Records can be written one after the other to the same file: MappedSetFile opens such a file
+ * read-only with mmap, and each SetView reads its record in place, without copying or parsing it
+ */
+
+/*
+ * Values per block, by default
+ */
+inline constexpr std::uint32_t default_block_size = 128;
+
+/*
+ * Write the sorted unique ints V[0, n) to stream os as one record
+ * block_size == 0 writes the record without block table
+ */
+void write_sorted_values(std::ostream& os, const int* V, std::size_t n,
+                         std::uint32_t block_size = default_block_size);
+
+/*
+ * Read one record from stream is and return its values, sorted
+ * If the record is not valid, the failbit of is is set and an empty vector is returned
+ */
+std::vector<int> read_sorted_values(std::istream& is);
+
+/** Class to read a record of the binary format in place
+ *
+ * A SetView does not own the bytes of the record: they must stay valid (and unchanged) as long as
+ * the SetView is used. Creating a SetView reads only the header
+ * The constructor throws std::runtime_error if the bytes do not start with a valid header
+ * values() checks the whole record and throws std::runtime_error if it is not valid; is_member
+ * decodes a single block, and only throws if that block cannot be decoded
+ */
+class SetView {
+
+public:
+    /*
+     * View of the record at the start of bytes (bytes may continue after the record)
+     */
+    explicit SetView(std::span<const std::byte> bytes);
+
+    bool is_empty() const {
+        return counter == 0;
+    }
+
+    size_t cardinality() const {
+        return counter;
+    }
+
+    /*
+     * Number of bytes of the record: the next record of a file starts right after it
+     */
+    size_t size_bytes() const {
+        return record.size();
+    }
+
+    /*
+     * Test whether val belongs to the set
+     * With a block table: O(log(n / block_size) + block_size), otherwise O(n)
+     */
+    bool is_member(int val) const;
+
+    /*
+     * All values, in increasing order
+     */
+    std::vector<int> values() const;
+
+private:
+    std::span<const std::byte> record;  // header, block table, and data
+    std::span<const std::byte> table;   // block table, empty if the record has none
+    std::span<const std::byte> data;    // varint data
+    size_t counter;                     // number of values
+    size_t block_size;                  // values per block (counter if the record has no table)
+
+    /*
+     * Decode the block starting at p, whose first value is the index-th value of the set
+     * Call f(value) for each value of the block until f returns false
+     * Return a pointer past the data of the block, or nullptr if f returned false
+     */
+    template <typename F>
+    const std::byte* decode_block(const std::byte* p, std::size_t index, F f) const;
+
+    /*
+     * Write the set to stream os, as Set::write_to_stream
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /*
+     * Overloaded operator<<
+     * \param os ostream object where the set S elements are written
+     */
+    friend std::ostream& operator<<(std::ostream& os, const SetView& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+};
+
+/** Class to map a file of records read-only into memory
+ *
+ * The file is mapped with mmap (MapViewOfFile on Windows): opening it does not read it, and the
+ * operating system loads the pages when a SetView touches them, so loading many sets costs I/O
+ * and no parsing. The mapping is released by the destructor
+ * The constructor throws std::system_error if the file cannot be opened or mapped
+ */
+class MappedSetFile {
+
+public:
+    explicit MappedSetFile(const std::string& path);
+
+    MappedSetFile(const MappedSetFile&) = delete;
+    MappedSetFile& operator=(const MappedSetFile&) = delete;
+
+    ~MappedSetFile();
+
+    /*
+     * All bytes of the file
+     */
+    std::span<const std::byte> bytes() const {
+        return {begin, length};
+    }
+
+    /*
+     * Views of all records of the file, in order
+     * Throws std::runtime_error if the file does not consist of valid records
+     */
+    std::vector<SetView> sets() const;
+
+private:
+    const std::byte* begin{nullptr};
+    std::size_t length{0};
+};
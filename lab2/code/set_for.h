@@ -0,0 +1,22 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+
+#include "set.h"
+#include "flat_set.h"
+
+/*
+ * The Set implementation for values of type T, chosen at compile time
+ *
+ * Trivially copyable values (ints, 64-bit ids, small structs) are stored contiguously in a
+ * BasicFlatSet: copying them is a memcpy, and ints and 64-bit integers (std::int64_t and
+ * std::uint64_t) in increasing order use the SIMD and parallel merge kernels. Other values (e.g.
+ * std::string) are stored in the Nodes of a BasicSet. The merges of the set operations copy every
+ * value of the result into a new Node, but the values already in a Set stay in their Nodes: moving
+ * a Set relinks its Nodes, and +=, *=, -= (and +, *, - on an rvalue Set) update the left operand
+ * in place, so its values are never copied or moved
+ */
+template <typename T, typename Compare = std::less<T>>
+using SetFor = std::conditional_t<std::is_trivially_copyable_v<T>, BasicFlatSet<T, Compare>,
+                                  BasicSet<T, Compare>>;
@@ -0,0 +1,245 @@
+#include "set_snapshot.h"
+
+#include <utility>
+
+/** Class SetSnapshot::Node
+ *
+ * This class represents a node of the treap of a SetSnapshot
+ * A Node is never modified once it belongs to a SetSnapshot, so it can be shared by many versions
+ * The functions creating new versions copy the Nodes they would modify (path copying)
+ */
+class SetSnapshot::Node {
+public:
+    Node(int val, NodePtr l, NodePtr r)
+        : value{val}
+        , priority{priority_of(val)}
+        , size{1 + size_of(l) + size_of(r)}
+        , left{std::move(l)}
+        , right{std::move(r)} {
+    }
+
+    /*
+     * Priority of the Node storing val: a bijective hash (the MurmurHash3 finalizer), so two
+     * values never have the same priority
+     */
+    static std::uint32_t priority_of(int val) {
+        auto h = static_cast<std::uint32_t>(val);
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    static size_t size_of(const NodePtr& t) {
+        return t ? t->size : 0;
+    }
+
+    /*
+     * Return the tree t with val inserted, val must not belong to t
+     */
+    static NodePtr insert(const NodePtr& t, int val, std::uint32_t p) {
+        if (!t)
+            return std::make_shared<const Node>(val, nullptr, nullptr);
+
+        if (p > t->priority) {  // the new Node is the root of this subtree
+            auto [l, r] = split(t, val);
+            return std::make_shared<const Node>(val, std::move(l), std::move(r));
+        }
+
+        if (val < t->value)
+            return std::make_shared<const Node>(t->value, insert(t->left, val, p), t->right);
+
+        return std::make_shared<const Node>(t->value, t->left, insert(t->right, val, p));
+    }
+
+    /*
+     * Return the tree t without val, val must belong to t
+     */
+    static NodePtr erase(const NodePtr& t, int val) {
+        if (val == t->value)
+            return join(t->left, t->right);
+
+        if (val < t->value)
+            return std::make_shared<const Node>(t->value, erase(t->left, val), t->right);
+
+        return std::make_shared<const Node>(t->value, t->left, erase(t->right, val));
+    }
+
+    /*
+     * Split the tree t into the values smaller than val and the values larger than val
+     */
+    static std::pair<NodePtr, NodePtr> split(const NodePtr& t, int val) {
+        if (!t)
+            return {};
+
+        if (t->value < val) {
+            auto [l, r] = split(t->right, val);
+            return {std::make_shared<const Node>(t->value, t->left, std::move(l)), std::move(r)};
+        }
+
+        auto [l, r] = split(t->left, val);
+        return {std::move(l), std::make_shared<const Node>(t->value, std::move(r), t->right)};
+    }
+
+    /*
+     * Join the trees l and r, all values of l are smaller than all values of r
+     */
+    static NodePtr join(const NodePtr& l, const NodePtr& r) {
+        if (!l) return r;
+        if (!r) return l;
+
+        if (l->priority > r->priority)
+            return std::make_shared<const Node>(l->value, l->left, join(l->right, r));
+
+        return std::make_shared<const Node>(r->value, join(l, r->left), r->right);
+    }
+
+    /*
+     * Test whether the trees a and b store the same values
+     * The same values give the same tree, so the trees are compared Node by Node
+     */
+    static bool equal(const Node* a, const Node* b) {
+        if (a == b)  // shared subtree
+            return true;
+
+        if (!a || !b || a->value != b->value || a->size != b->size)
+            return false;
+
+        return equal(a->left.get(), b->left.get()) && equal(a->right.get(), b->right.get());
+    }
+
+    /*
+     * Call f(value) for all values of the tree t, in increasing order
+     */
+    template <typename F>
+    static void for_each(const Node* t, F& f) {
+        while (t) {
+            for_each(t->left.get(), f);
+            f(t->value);
+            t = t->right.get();
+        }
+    }
+
+    // Data members
+    int value;               // int stored in the Node
+    std::uint32_t priority;  // larger than the priorities of the Nodes below
+    size_t size;             // number of Nodes in the subtree of the Node
+    NodePtr left;            // subtree of the smaller values
+    NodePtr right;           // subtree of the larger values
+};
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * Constructor to create a SetSnapshot from a sorted vector of unique ints
+ * Nodes are added from left to right and only the right spine of the tree changes, so every
+ * Node is pushed to and popped from spine once. A Node is complete when it is popped
+ */
+SetSnapshot::SetSnapshot(const std::vector<int>& list_of_values) {
+    std::vector<std::shared_ptr<Node>> spine;  // from the root down
+
+    auto pop = [&spine] {
+        std::shared_ptr<Node> n = std::move(spine.back());
+        spine.pop_back();
+        n->size = 1 + Node::size_of(n->left) + Node::size_of(n->right);
+        return n;
+    };
+
+    for (int val : list_of_values) {
+        auto n = std::make_shared<Node>(val, nullptr, nullptr);
+
+        // Nodes with a lower priority become the left subtree of the new Node
+        std::shared_ptr<Node> below;
+        while (!spine.empty() && spine.back()->priority < n->priority)
+            below = pop();
+
+        n->left = std::move(below);
+        if (!spine.empty())
+            spine.back()->right = n;
+
+        spine.push_back(std::move(n));
+    }
+
+    std::shared_ptr<Node> top;
+    while (!spine.empty())
+        top = pop();
+
+    root = std::move(top);
+}
+
+/*
+ * Return a new version with val inserted, or *this if val is already a member
+ */
+SetSnapshot SetSnapshot::insert(int val) const {
+    if (is_member(val))
+        return *this;
+
+    return SetSnapshot{Node::insert(root, val, Node::priority_of(val))};
+}
+
+/*
+ * Return a new version without val, or *this if val is not a member
+ */
+SetSnapshot SetSnapshot::erase(int val) const {
+    if (!is_member(val))
+        return *this;
+
+    return SetSnapshot{Node::erase(root, val)};
+}
+
+/*
+ * Test whether val belongs to the SetSnapshot
+ */
+bool SetSnapshot::is_member(int val) const {
+    const Node* t = root.get();
+
+    while (t && t->value != val)
+        t = (val < t->value) ? t->left.get() : t->right.get();
+
+    return t != nullptr;
+}
+
+size_t SetSnapshot::cardinality() const {
+    return Node::size_of(root);
+}
+
+/*
+ * All values, in increasing order
+ */
+std::vector<int> SetSnapshot::values() const {
+    std::vector<int> V;
+    V.reserve(cardinality());
+
+    auto add = [&V](int val) { V.push_back(val); };
+    Node::for_each(root.get(), add);
+    return V;
+}
+
+/*
+ * Test whether SetSnapshot *this and S represent the same set
+ */
+bool SetSnapshot::operator==(const SetSnapshot& S) const {
+    return Node::equal(root.get(), S.root.get());
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Write SetSnapshot *this to stream os
+ */
+void SetSnapshot::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        auto write = [&os](int val) { os << val << " "; };
+        Node::for_each(root.get(), write);
+        os << "}";
+    }
+}
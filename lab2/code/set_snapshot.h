@@ -0,0 +1,146 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/** Class to represent an immutable Set of ints
+ *
+ * A SetSnapshot never changes: insert and erase return a new version and leave *this as it is
+ * The versions share their nodes (structural sharing): a new version only copies the O(log n)
+ * nodes on the path to the inserted or erased value, so copying or keeping old versions is cheap
+ * Since nothing is ever modified, any number of threads can read a SetSnapshot without locks
+ *
+ * The values are stored in a treap: a binary search tree by value that is also a heap by priority
+ * The priority of a node is a hash of its value, so the tree is balanced in expectation and the
+ * same values always give the same tree
+ */
+class SetSnapshot {
+
+public:
+    /*
+     *  Default constructor: create an empty SetSnapshot
+     */
+    SetSnapshot() = default;
+
+    /*
+     * Constructor to create a SetSnapshot from a sorted vector of unique ints
+     * The tree is built in O(n), without rebalancing
+     */
+    explicit SetSnapshot(const std::vector<int>& list_of_values);
+
+    /*
+     * Return a new version with val inserted, or *this if val is already a member
+     * O(log n) expected, the new version shares all other nodes with *this
+     */
+    [[nodiscard]] SetSnapshot insert(int val) const;
+
+    /*
+     * Return a new version without val, or *this if val is not a member
+     * O(log n) expected, the new version shares all other nodes with *this
+     */
+    [[nodiscard]] SetSnapshot erase(int val) const;
+
+    /*
+     * Test whether val belongs to the SetSnapshot
+     * O(log n) expected
+     */
+    bool is_member(int val) const;
+
+    bool is_empty() const {
+        return root == nullptr;
+    }
+
+    size_t cardinality() const;
+
+    /*
+     * All values, in increasing order
+     */
+    std::vector<int> values() const;
+
+    /*
+     * Test whether SetSnapshot *this and S represent the same set
+     * Subtrees shared by both versions are not visited
+     */
+    bool operator==(const SetSnapshot& S) const;
+
+private:
+    class Node;  // nested class defined in set_snapshot.cpp
+
+    using NodePtr = std::shared_ptr<const Node>;
+
+    NodePtr root;
+
+    explicit SetSnapshot(NodePtr r) : root{std::move(r)} {
+    }
+
+    /*
+     * Write SetSnapshot *this to stream os
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    friend class SetPublisher;
+
+    /*
+     * Overloaded operator<<
+     * \param os ostream object where the set S elements are written
+     */
+    friend std::ostream& operator<<(std::ostream& os, const SetSnapshot& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+};
+
+/** Class to share the current version of a SetSnapshot between threads
+ *
+ * Readers call load() to get the current version, and keep it as long as they need it: it stays
+ * valid and unchanged even if a writer publishes new versions in the meantime
+ * Writers call publish() or update(): the current version is replaced by an atomic pointer swap,
+ * and the nodes of old versions are freed when their last reader drops them
+ */
+class SetPublisher {
+
+public:
+    explicit SetPublisher(const SetSnapshot& initial = SetSnapshot{}) : current{initial.root} {
+    }
+
+    SetPublisher(const SetPublisher&) = delete;
+    SetPublisher& operator=(const SetPublisher&) = delete;
+
+    /*
+     * The current version
+     */
+    SetSnapshot load() const {
+        return SetSnapshot{current.load(std::memory_order_acquire)};
+    }
+
+    /*
+     * Make S the current version
+     */
+    void publish(const SetSnapshot& S) {
+        current.store(S.root, std::memory_order_release);
+    }
+
+    /*
+     * Replace the current version V by f(V)
+     * If another writer publishes a version first, f is called again with that version,
+     * so no update is lost when there are several writers
+     */
+    template <typename F>
+    void update(F f) {
+        SetSnapshot::NodePtr expected = current.load(std::memory_order_acquire);
+
+        while (true) {
+            SetSnapshot next = f(SetSnapshot{expected});
+            if (current.compare_exchange_weak(expected, next.root, std::memory_order_acq_rel,
+                                              std::memory_order_acquire))
+                return;
+        }
+    }
+
+private:
+    std::atomic<SetSnapshot::NodePtr> current;
+};
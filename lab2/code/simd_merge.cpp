@@ -0,0 +1,480 @@
+#include "simd_merge.h"
+#include "search.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/*
+ * memmove that accepts an empty range at a null pointer, e.g. the data() of an empty vector
+ */
+template <typename T>
+void move_values(T* out, const T* first, std::size_t count) {
+    if (count > 0)
+        std::memmove(out, first, count * sizeof(T));
+}
+
+/*
+ * Exponential search: return a pointer to the first value >= val in the sorted array [first, last)
+ * Cost O(log d), where d is the distance from first to the result
+ */
+template <typename T>
+const T* gallop(const T* first, const T* last, T val) {
+    if (first == last || *first >= val)
+        return first;
+
+    // Invariant: *lo < val
+    const T* lo = first;
+    std::size_t step = 1;
+    while (step < static_cast<std::size_t>(last - lo) && lo[step] < val) {
+        lo += step;
+        step *= 2;
+    }
+
+    const std::size_t n = std::min(step, static_cast<std::size_t>(last - lo));  // lo[n] >= val or lo + n == last
+    return branchless_lower_bound(lo + 1, n - 1, val);
+}
+
+/*
+ * Intersection of a short array s with a long array l: every value of s is searched in l
+ */
+template <typename T>
+std::size_t intersection_gallop(const T* s, std::size_t ns, const T* l, std::size_t nl, T* out) {
+    const T* p = l;
+    const T* l_end = l + nl;
+    std::size_t k = 0;
+
+    for (std::size_t i = 0; i < ns && p != l_end; ++i) {
+        const T x = s[i];
+        p = gallop(p, l_end, x);
+        if (p != l_end && *p == x)
+            out[k++] = x;
+    }
+
+    return k;
+}
+
+/*
+ * Union of a short array s with a long array l: the runs of l between the values of s are copied
+ */
+template <typename T>
+std::size_t union_gallop(const T* s, std::size_t ns, const T* l, std::size_t nl, T* out) {
+    const T* p = l;
+    const T* l_end = l + nl;
+    std::size_t k = 0;
+
+    for (std::size_t i = 0; i < ns; ++i) {
+        const T x = s[i];
+        const T* q = gallop(p, l_end, x);
+
+        move_values(out + k, p, static_cast<std::size_t>(q - p));
+        k += static_cast<std::size_t>(q - p);
+        out[k++] = x;
+        p = q + (q != l_end && *q == x);
+    }
+
+    move_values(out + k, p, static_cast<std::size_t>(l_end - p));
+    return k + static_cast<std::size_t>(l_end - p);
+}
+
+/*
+ * Difference a-b for a short array a: every value of a is searched in b
+ */
+template <typename T>
+std::size_t difference_gallop_short(const T* a, std::size_t n, const T* b, std::size_t m, T* out) {
+    const T* p = b;
+    const T* b_end = b + m;
+    std::size_t k = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const T x = a[i];
+        p = gallop(p, b_end, x);
+        out[k] = x;
+        k += (p == b_end || *p != x);
+    }
+
+    return k;
+}
+
+/*
+ * Difference a-b for a short array b: the runs of a between the values of b are kept
+ * memmove, since out may be a
+ */
+template <typename T>
+std::size_t difference_gallop_long(const T* a, std::size_t n, const T* b, std::size_t m, T* out) {
+    const T* p = a;
+    const T* a_end = a + n;
+    std::size_t k = 0;
+
+    for (std::size_t j = 0; j < m && p != a_end; ++j) {
+        const T* q = gallop(p, a_end, b[j]);
+
+        move_values(out + k, p, static_cast<std::size_t>(q - p));
+        k += static_cast<std::size_t>(q - p);
+        p = q + (q != a_end && *q == b[j]);
+    }
+
+    move_values(out + k, p, static_cast<std::size_t>(a_end - p));
+    return k + static_cast<std::size_t>(a_end - p);
+}
+
+#if defined(__AVX2__)
+
+__m256i load_block(const void* p) {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+
+/*
+ * The operations of the kernels on a block, an AVX2 register of sorted values of type T
+ */
+template <typename T>
+struct Block;
+
+/*
+ * Block of 8 ints
+ */
+template <>
+struct Block<int> {
+    static constexpr std::size_t lanes = 8;
+
+    /*
+     * Last (largest) value of the block
+     */
+    static int back(__m256i v) {
+        return _mm256_extract_epi32(v, 7);
+    }
+
+    /*
+     * Bit i is set if lane i of va is equal to some lane of vb
+     * va is compared with the 8 rotations of vb, i.e. all 64 pairs of values
+     */
+    static unsigned match_mask(__m256i va, __m256i vb) {
+        const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+        __m256i eq = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+        }
+
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+    }
+
+    /*
+     * Number of lanes of the sorted block v that are <= x (they are the first lanes)
+     */
+    static std::size_t lanes_at_most(__m256i v, int x) {
+        const __m256i gt = _mm256_cmpgt_epi32(v, _mm256_set1_epi32(x));
+        return 8 - static_cast<std::size_t>(std::popcount(
+                       static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(gt)))));
+    }
+
+#if !(defined(__AVX512F__) && defined(__AVX512VL__))
+    // For every 8-bit mask: lane indices of the set bits, in order
+    // Permuting a vector with entry m moves the lanes selected by m to the front (a compress)
+    static constexpr auto compress_lut = [] {
+        std::array<std::array<std::int32_t, 8>, 256> lut{};
+        for (unsigned m = 0; m < 256; ++m) {
+            int k = 0;
+            for (int lane = 0; lane < 8; ++lane)
+                if (m & (1u << lane)) lut[m][k++] = lane;
+        }
+        return lut;
+    }();
+#endif
+
+    /*
+     * Write the lanes of v selected by mask to out + k, in order, and return the new k
+     * Nothing else is written, so the kernels can compact an array in place
+     */
+    static std::size_t compress_store(int* out, std::size_t k, unsigned mask, __m256i v) {
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+        _mm256_mask_compressstoreu_epi32(out + k, static_cast<__mmask8>(mask), v);
+#else
+        const __m256i to_front = load_block(compress_lut[mask].data());
+        const int count = std::popcount(mask);
+        const __m256i first_lanes =
+            _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        _mm256_maskstore_epi32(out + k, first_lanes, _mm256_permutevar8x32_epi32(v, to_front));
+#endif
+        return k + static_cast<std::size_t>(std::popcount(mask));
+    }
+};
+
+/*
+ * Block of 4 signed or unsigned 64-bit integers
+ */
+template <typename T>
+    requires(sizeof(T) == 8)
+struct Block<T> {
+    static constexpr std::size_t lanes = 4;
+
+    static T back(__m256i v) {
+        return static_cast<T>(_mm256_extract_epi64(v, 3));
+    }
+
+    /*
+     * va is compared with the 4 rotations of vb, i.e. all 16 pairs of values
+     */
+    static unsigned match_mask(__m256i va, __m256i vb) {
+        __m256i eq = _mm256_cmpeq_epi64(va, vb);
+        for (int r = 1; r < 4; ++r) {
+            vb = _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1));
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, vb));
+        }
+
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+    }
+
+    /*
+     * AVX2 only compares signed 64-bit integers: unsigned ones are compared with the sign bit
+     * flipped
+     */
+    static std::size_t lanes_at_most(__m256i v, T x) {
+        const __m256i flip = _mm256_set1_epi64x(std::is_signed_v<T> ? 0 : INT64_MIN);
+        const __m256i bound = _mm256_set1_epi64x(static_cast<long long>(x));
+        const __m256i gt =
+            _mm256_cmpgt_epi64(_mm256_xor_si256(v, flip), _mm256_xor_si256(bound, flip));
+        return 4 - static_cast<std::size_t>(std::popcount(
+                       static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(gt)))));
+    }
+
+#if !(defined(__AVX512F__) && defined(__AVX512VL__))
+    // For every 4-bit mask: the two 32-bit halves of the lanes of the set bits, in order
+    static constexpr auto compress_lut = [] {
+        std::array<std::array<std::int32_t, 8>, 16> lut{};
+        for (unsigned m = 0; m < 16; ++m) {
+            int k = 0;
+            for (int lane = 0; lane < 4; ++lane) {
+                if (m & (1u << lane)) {
+                    lut[m][k++] = 2 * lane;
+                    lut[m][k++] = 2 * lane + 1;
+                }
+            }
+        }
+        return lut;
+    }();
+#endif
+
+    static std::size_t compress_store(T* out, std::size_t k, unsigned mask, __m256i v) {
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+        _mm256_mask_compressstoreu_epi64(out + k, static_cast<__mmask8>(mask), v);
+#else
+        const __m256i to_front = load_block(compress_lut[mask].data());
+        const long long count = std::popcount(mask);
+        const __m256i first_lanes =
+            _mm256_cmpgt_epi64(_mm256_set1_epi64x(count), _mm256_setr_epi64x(0, 1, 2, 3));
+        _mm256_maskstore_epi64(reinterpret_cast<long long*>(out + k), first_lanes,
+                               _mm256_permutevar8x32_epi32(v, to_front));
+#endif
+        return k + static_cast<std::size_t>(std::popcount(mask));
+    }
+};
+
+#endif
+
+}  // namespace
+
+/*
+ * Values in both a[0, n) and b[0, m)
+ * Blocks of values of a and b are compared (Schlegel et al., Lemire et al.), and the block with
+ * the smaller last value is replaced by the next one. In place, the result never passes the
+ * values of a not read yet
+ */
+template <MergeValue T>
+std::size_t sorted_intersection(const T* a, std::size_t n, const T* b, std::size_t m, T* out) {
+    if (n * gallop_ratio < m)
+        return intersection_gallop(a, n, b, m, out);
+
+    if (m * gallop_ratio < n)
+        return intersection_gallop(b, m, a, n, out);
+
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t k = 0;
+
+#if defined(__AVX2__)
+    using B = Block<T>;
+    constexpr std::size_t L = B::lanes;
+
+    if (n >= L && m >= L) {
+        __m256i va = load_block(a);
+        __m256i vb = load_block(b);
+
+        while (true) {
+            k = B::compress_store(out, k, B::match_mask(va, vb), va);
+
+            const T a_max = B::back(va);
+            const T b_max = B::back(vb);
+            const bool next_a = a_max <= b_max;
+            const bool next_b = b_max <= a_max;
+            i += L * next_a;
+            j += L * next_b;
+
+            if (i + L > n || j + L > m) {
+                // The lanes of va not larger than b[j-1] cannot match any more values of b
+                if (!next_a)
+                    i += B::lanes_at_most(va, b[j - 1]);
+                break;
+            }
+
+            if (next_a) va = load_block(a + i);
+            if (next_b) vb = load_block(b + j);
+        }
+    }
+#endif
+
+    // Branchless merge: x is always written, but k only advances on a match
+    while (i < n && j < m) {
+        const T x = a[i];
+        const T y = b[j];
+        out[k] = x;
+        k += (x == y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+
+    return k;
+}
+
+/*
+ * Values in a[0, n) or in b[0, m)
+ */
+template <MergeValue T>
+std::size_t sorted_union(const T* a, std::size_t n, const T* b, std::size_t m, T* out) {
+    if (n * gallop_ratio < m)
+        return union_gallop(a, n, b, m, out);
+
+    if (m * gallop_ratio < n)
+        return union_gallop(b, m, a, n, out);
+
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t k = 0;
+
+    // Branchless merge: the smaller value is written, equal values are written once
+    while (i < n && j < m) {
+        const T x = a[i];
+        const T y = b[j];
+        out[k++] = (x < y) ? x : y;
+        i += (x <= y);
+        j += (y <= x);
+    }
+
+    move_values(out + k, a + i, n - i);
+    k += n - i;
+    move_values(out + k, b + j, m - j);
+    return k + (m - j);
+}
+
+/*
+ * Values in a[0, n) that are not in b[0, m)
+ * Same block comparisons as sorted_intersection: the lanes of a block of a matching no value of b
+ * are written when the block is done
+ */
+template <MergeValue T>
+std::size_t sorted_difference(const T* a, std::size_t n, const T* b, std::size_t m, T* out) {
+    if (n * gallop_ratio < m)
+        return difference_gallop_short(a, n, b, m, out);
+
+    if (m * gallop_ratio < n)
+        return difference_gallop_long(a, n, b, m, out);
+
+    std::size_t i = 0;
+    std::size_t j = 0;
+    std::size_t k = 0;
+
+#if defined(__AVX2__)
+    using B = Block<T>;
+    constexpr std::size_t L = B::lanes;
+    constexpr unsigned all_lanes = (1u << L) - 1;
+
+    if (n >= L && m >= L) {
+        __m256i va = load_block(a);
+        __m256i vb = load_block(b);
+        unsigned found = 0;  // lanes of va found in b so far
+
+        while (true) {
+            found |= B::match_mask(va, vb);
+
+            const T a_max = B::back(va);
+            const T b_max = B::back(vb);
+            const bool next_a = a_max <= b_max;
+            const bool next_b = b_max <= a_max;
+
+            if (next_a) {
+                k = B::compress_store(out, k, ~found & all_lanes, va);
+                found = 0;
+            }
+            i += L * next_a;
+            j += L * next_b;
+
+            if (i + L > n || j + L > m) {
+                // The lanes of va not larger than b[j-1] cannot match any more values of b
+                if (!next_a) {
+                    const std::size_t done = B::lanes_at_most(va, b[j - 1]);
+                    k = B::compress_store(out, k, ~found & ((1u << done) - 1), va);
+                    i += done;
+                }
+                break;
+            }
+
+            if (next_a) va = load_block(a + i);
+            if (next_b) vb = load_block(b + j);
+        }
+    }
+#endif
+
+    // Branchless merge: x is always written, but k only advances if x is not in b
+    while (i < n && j < m) {
+        const T x = a[i];
+        const T y = b[j];
+        out[k] = x;
+        k += (x < y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+
+    move_values(out + k, a + i, n - i);
+    return k + (n - i);
+}
+
+template std::size_t sorted_intersection(const int*, std::size_t, const int*, std::size_t, int*);
+template std::size_t sorted_union(const int*, std::size_t, const int*, std::size_t, int*);
+template std::size_t sorted_difference(const int*, std::size_t, const int*, std::size_t, int*);
+
+template std::size_t sorted_intersection(const std::int64_t*, std::size_t, const std::int64_t*,
+                                         std::size_t, std::int64_t*);
+template std::size_t sorted_union(const std::int64_t*, std::size_t, const std::int64_t*,
+                                  std::size_t, std::int64_t*);
+template std::size_t sorted_difference(const std::int64_t*, std::size_t, const std::int64_t*,
+                                       std::size_t, std::int64_t*);
+
+template std::size_t sorted_intersection(const std::uint64_t*, std::size_t, const std::uint64_t*,
+                                         std::size_t, std::uint64_t*);
+template std::size_t sorted_union(const std::uint64_t*, std::size_t, const std::uint64_t*,
+                                  std::size_t, std::uint64_t*);
+template std::size_t sorted_difference(const std::uint64_t*, std::size_t, const std::uint64_t*,
+                                       std::size_t, std::uint64_t*);
+
+/*
+ * Name of the block kernel selected at compile time: "avx512", "avx2" or "scalar"
+ */
+const char* merge_kernel_name() {
+#if defined(__AVX2__) && defined(__AVX512F__) && defined(__AVX512VL__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
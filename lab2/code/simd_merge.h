@@ -0,0 +1,58 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Merge kernels for sorted arrays of unique ints or 64-bit integers, used by FlatSet
+ *
+ * When one array is much longer than the other (see gallop_ratio) every value of the short array
+ * is located in the long one by exponential search, so the cost is O(m log(n/m)) instead of O(n+m)
+ * Otherwise the arrays are merged in blocks of one AVX2 register, 8 ints or 4 64-bit integers, with
+ * AVX2 compares (all pairs of values of two blocks at once) if the compiler targets AVX2, e.g. with
+ * -march=native, and by a branchless scalar loop for the rest
+ *
+ * Each kernel writes the result to out and returns the number of values written
+ */
+
+/*
+ * Arrays whose sizes differ by more than this factor are merged by galloping
+ */
+inline constexpr std::size_t gallop_ratio = 32;
+
+/*
+ * The value types of the kernels, in increasing order
+ * They are compiled once, in simd_merge.cpp
+ */
+template <typename T>
+concept MergeValue =
+    std::same_as<T, int> || std::same_as<T, std::int64_t> || std::same_as<T, std::uint64_t>;
+
+/*
+ * Values in both a[0, n) and b[0, m)
+ * out must have room for min(n, m) values. out may be a (the result is then computed in place),
+ * otherwise it must not overlap the input arrays
+ */
+template <MergeValue T>
+std::size_t sorted_intersection(const T* a, std::size_t n, const T* b, std::size_t m, T* out);
+
+/*
+ * Values in a[0, n) or in b[0, m)
+ * out must have room for n + m values and must not overlap the input arrays
+ */
+template <MergeValue T>
+std::size_t sorted_union(const T* a, std::size_t n, const T* b, std::size_t m, T* out);
+
+/*
+ * Values in a[0, n) that are not in b[0, m)
+ * out must have room for n values. out may be a (the result is then computed in place),
+ * otherwise it must not overlap the input arrays
+ */
+template <MergeValue T>
+std::size_t sorted_difference(const T* a, std::size_t n, const T* b, std::size_t m, T* out);
+
+/*
+ * Name of the block kernel selected at compile time: "avx512", "avx2" or "scalar"
+ */
+const char* merge_kernel_name();
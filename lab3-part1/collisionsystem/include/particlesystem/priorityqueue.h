@@ -3,21 +3,84 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <new>
 
 // #define TEST_PRIORITY_QUEUE
 
+/**
+ * Index arithmetic of a heap where every node has D children
+ * The root is in slot 0 and the children of node i are in slots D * i + 1 to D * i + D
+ * In storage where slot 1 starts a cache line (see CacheAlignedAllocator), the children of a node
+ * then share a cache line whenever D * sizeof(element) divides the size of a cache line
+ */
+template <std::size_t D>
+struct HeapLayout {
+    static_assert(D >= 2, "a heap node has at least two children");
+
+    static constexpr std::size_t root = 0;
+
+    static constexpr std::size_t firstChild(std::size_t i) { return D * i + 1; }
+
+    static constexpr std::size_t parent(std::size_t i) { return (i - 1) / D; }
+};
+
+/**
+ * Allocator of storage where slot Skew starts a cache line, used for the heap vectors
+ * The storage is shifted from an aligned block, so that no slot is wasted before slot Skew
+ */
+template <class T, std::size_t Skew = 0>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = CacheAlignedAllocator<U, Skew>;
+    };
+
+    static constexpr std::size_t alignment = std::max<std::size_t>(64, alignof(T));
+
+    // a multiple of alignof(T), since both sizeof(T) and alignment are
+    static constexpr std::size_t shift = (alignment - Skew * sizeof(T) % alignment) % alignment;
+
+    CacheAlignedAllocator() = default;
+
+    template <class U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U, Skew>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        void* block = ::operator new(n * sizeof(T) + shift, std::align_val_t{alignment});
+        return reinterpret_cast<T*>(static_cast<std::byte*>(block) + shift);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        void* block = reinterpret_cast<std::byte*>(p) - shift;
+        ::operator delete(block, n * sizeof(T) + shift, std::align_val_t{alignment});
+    }
+
+    friend bool operator==(const CacheAlignedAllocator&, const CacheAlignedAllocator&) {
+        return true;
+    }
+};
+
 /**
  * A heap based priority queue where the root is the smallest element -- min heap
+ * Every node has D children: D = 4 or D = 8 halves the height of the heap compared to D = 2, and
+ * the children compared at each level are in one cache line, which pays off for large queues
+ * Elements are moved, never copied, inside the queue: insert(Comparable&&), emplace, top, and pop
+ * work for move-only elements, and no element is default constructed
  */
-template <class Comparable>
+template <class Comparable, std::size_t D = 2>
 class PriorityQueue {
 public:
     /**
      * Constructor to create a queue with the given capacity
      */
-    explicit PriorityQueue(int initCapacity = 100) : orderOK{true} {
-        pq.reserve(initCapacity + 1);
-        makeEmpty();
+    explicit PriorityQueue(int initCapacity = 100) : orderedSize{0} {
+        pq.reserve(initCapacity);
         assert(isEmpty());
     }
 
@@ -25,7 +88,10 @@ public:
      * Constructor to initialize a priority queue based on a given vector V
      * Assumes V[0] is not used
      */
-    explicit PriorityQueue(const std::vector<Comparable>& V) : pq{V} {
+    explicit PriorityQueue(const std::vector<Comparable>& V) : orderedSize{0} {
+        assert(!V.empty());
+        pq.assign(V.begin() + 1, V.end());
+
         heapify();
 #ifdef TEST_PRIORITY_QUEUE
         assert(isMinHeap());
@@ -37,7 +103,7 @@ public:
      */
     void makeEmpty() {
         pq.clear();
-        pq.push_back(Comparable{});
+        orderedSize = 0;
     }
 
     /**
@@ -45,121 +111,284 @@ public:
      * Return true if the queue is empty, false otherwise
      */
     bool isEmpty() const {
-        return pq.size() == 1;  // slot zero is not used
+        return pq.empty();
     }
 
     /**
      * Get the size of the queue, i.e. number of elements in the queue
      */
-    size_t size() const { return pq.size() - 1; }
+    size_t size() const { return pq.size(); }
 
     /**
-     * Get the smallest element in the queue
+     * Get a copy of the smallest element in the queue
      */
     Comparable findMin() {
+        return top();
+    }
+
+    /**
+     * Get the smallest element in the queue, without copying it
+     */
+    const Comparable& top() {
         assert(isEmpty() == false);
-        return pq[1];
+
+        heapify();  // place the tossed elements, if any
+        return pq[Layout::root];
     }
 
+    /**
+     * Remove the smallest element in the queue and return it, moved out of the queue
+     */
+    Comparable pop();
+
     /**
      * Remove and return the smallest element in the queue
      */
-    Comparable deleteMin();
+    Comparable deleteMin() { return pop(); }
 
     /**
      * Add a new element x to the queue
      */
-    void insert(const Comparable& x);
+    void insert(const Comparable& x) { emplace(x); }
+
+    void insert(Comparable&& x) { emplace(std::move(x)); }
+
+    /**
+     * Add a new element, constructed in the queue from args
+     */
+    template <class... Args>
+    void emplace(Args&&... args);
 
     /**
      * Insert element x in the end of the queue, without preserving the heap property
      */
     void toss(const Comparable& x);
 
+    void toss(Comparable&& x);
+
+    /**
+     * Add the elements in [first, last) to the queue
+     * The elements are placed one at a time when they are fewer than the elements already in the
+     * queue, otherwise the heap is built again, see heapify
+     * Use std::make_move_iterator to move the elements into the queue
+     */
+    template <class InputIt>
+    void insertRange(InputIt first, InputIt last) {
+        tossRange(first, last);
+        heapify();
+    }
+
+    /**
+     * Insert the elements in [first, last) in the end of the queue, without preserving the heap
+     * property: the next call to top, findMin, pop, or deleteMin places them all at once
+     */
+    template <class InputIt>
+    void tossRange(InputIt first, InputIt last) {
+        pq.insert(pq.end(), first, last);
+    }
+
 private:
-    std::vector<Comparable> pq;  // slot with index 0 not used
-    bool orderOK;  // flag to keep internal track of when the heap is ordered / not ordered
+    using Layout = HeapLayout<D>;
+
+    // Size in bytes of the subtrees that buildHeapBlocked builds in one go, about a L2 cache
+    static constexpr size_t heapifyBlockBytes = size_t{256} << 10;
+
+    std::vector<Comparable, CacheAlignedAllocator<Comparable, 1>> pq;  // the root in slot 0
+    size_t orderedSize;  // slots 0 to orderedSize - 1 form a heap, the slots after were tossed
 
     // Auxiliary member functions
 
     /**
-     * Restore the heap-ordering property
+     * Restore the heap-ordering property, i.e. place the tossed elements
      */
     void heapify();
 
+    /**
+     * Build a heap of the subtree of slot i bottom-up (Floyd), level by level
+     */
+    void buildHeap(size_t i);
+
+    /**
+     * Build a heap of the subtree of slot i, which has the given number of levels, bottom-up
+     * The subtrees of the children of i are built first, down to subtrees of heapifyBlockBytes
+     * that buildHeap builds in the cache, so that each level is not read from memory again
+     */
+    void buildHeapBlocked(size_t i, size_t levels);
+
+    /**
+     * Number of levels of a heap with n elements
+     */
+    static size_t height(size_t n) {
+        size_t h = 0;
+        for (size_t levelsSize = 0, width = 1; levelsSize < n; width *= D) {
+            levelsSize += width;
+            ++h;
+        }
+        return h;
+    }
+
+    /**
+     * Move the element in slot i down to its place
+     */
     void percolateDown(size_t i);
 
+    /**
+     * Move the element in slot i up to its place
+     */
+    void percolateUp(size_t i);
+
+    /**
+     * Return the slot of the smallest among the children c to c + D - 1, of the n slots in pq
+     */
+    size_t smallestChild(size_t c, size_t n) const {
+        size_t m = c;
+        const size_t last = std::min(c + D, n);
+        for (size_t k = c + 1; k < last; k++) {
+            if (pq[k] < pq[m]) m = k;
+        }
+        return m;
+    }
+
     /**
      * Test whether pq is a min heap
      */
     bool isMinHeap() const {
-        // If the heap has only one element, return true
-        if (std::ssize(pq) == 2) return true;
-
-        // For every element in the heap
-        for (int i = 1; i < std::ssize(pq)/2; i++)
-        {
-            // Check if the children are greater than the parent
-            if (pq[i] >= pq[2 * i] || (i < (std::ssize(pq) - 1) / 2 && pq[i] >= pq[2 * i + 1]))
-                return false;
+        // Check that no element is smaller than its parent
+        for (size_t i = Layout::root + 1; i < pq.size(); i++) {
+            if (pq[i] < pq[Layout::parent(i)]) return false;
         }
 
         return true;
     }
 };
 
-template <class Comparable>
-void PriorityQueue<Comparable>::percolateDown(size_t i) {
-    Comparable temp = pq[i];
-    auto c = 2 * i;  // left child
+/**
+ * Move the hole left by the element in slot i down, moving the smallest child up into the hole,
+ * until the element can fill the hole
+ */
+template <class Comparable, std::size_t D>
+void PriorityQueue<Comparable, D>::percolateDown(size_t i) {
+    Comparable temp = std::move(pq[i]);
+    const size_t n = pq.size();
 
-    while (c < pq.size()) {
-        if (c < pq.size() - 1) {
-            if (pq[c + 1] < pq[c])  // largest child?
-                c++;
-        }
-        // percolate down
-        if (pq[c] < temp) {
-            pq[i] = pq[c];
-            i = c;
-            c = 2 * i;
-        } else {
-            break;
-        }
+    for (size_t c = Layout::firstChild(i); c < n; c = Layout::firstChild(i)) {
+        const size_t m = smallestChild(c, n);
+        if (!(pq[m] < temp)) break;
+
+        pq[i] = std::move(pq[m]);
+        i = m;
     }
-    pq[i] = temp;
+    pq[i] = std::move(temp);
+}
+
+/**
+ * Move the hole left by the element in slot i up, moving the parent down into the hole,
+ * until the element can fill the hole
+ */
+template <class Comparable, std::size_t D>
+void PriorityQueue<Comparable, D>::percolateUp(size_t i) {
+    Comparable temp = std::move(pq[i]);
+
+    while (i > Layout::root && temp < pq[Layout::parent(i)]) {
+        pq[i] = std::move(pq[Layout::parent(i)]);
+        i = Layout::parent(i);
+    }
+    pq[i] = std::move(temp);
 }
 
 /**
  * Restore the heap property
+ * Cost model, for k tossed elements after a heap of n - k elements: percolating each one up costs
+ * up to height(n) moves, but a new element seldom goes up more than a level or two, and the levels
+ * near the root stay in the cache. Building the heap again costs a few moves per element, for all
+ * n elements. Measured with 4-ary heaps of up to 2M doubles, percolating up is faster until k is
+ * about n - k, even when every new element goes up to the root
  */
-template <class Comparable>
-void PriorityQueue<Comparable>::heapify() {
-    assert(pq.size() > 1);  // slot zero is not used
+template <class Comparable, std::size_t D>
+void PriorityQueue<Comparable, D>::heapify() {
+    const size_t n = pq.size();
+    const size_t k = n - orderedSize;
+
+    if (k == 0) return;
+
+    if (k <= orderedSize) {
+        for (size_t i = orderedSize; i < n; i++) {
+            percolateUp(i);
+        }
+    } else {
+        buildHeapBlocked(Layout::root, height(n));
+    }
+    orderedSize = n;
 
-    for (size_t i = (pq.size() - 1) / 2; i >= 1; --i) {
-        percolateDown(i);
+#ifdef TEST_PRIORITY_QUEUE
+    assert(isMinHeap());
+#endif
+}
+
+template <class Comparable, std::size_t D>
+void PriorityQueue<Comparable, D>::buildHeap(size_t i) {
+    const size_t n = pq.size();
+    if (Layout::firstChild(i) >= n) return;  // a leaf
+
+    // The internal slots of each level of the subtree, from level 0 (slot i) down
+    size_t first[64];
+    size_t last[64];
+    size_t levels = 0;
+    for (size_t lo = i, hi = i; lo < n && Layout::firstChild(lo) < n; levels++) {
+        first[levels] = lo;
+        last[levels] = std::min(hi, Layout::parent(n - 1));  // internal slots only
+        lo = Layout::firstChild(lo);
+        hi = Layout::firstChild(hi) + D - 1;
+    }
+
+    // from the last internal level up to slot i
+    while (levels-- > 0) {
+        for (size_t j = last[levels] + 1; j-- > first[levels];) {
+            percolateDown(j);
+        }
     }
-    orderOK = true;
+}
+
+template <class Comparable, std::size_t D>
+void PriorityQueue<Comparable, D>::buildHeapBlocked(size_t i, size_t levels) {
+    size_t subtreeSize = 1;
+    for (size_t l = 1; l < levels && subtreeSize * sizeof(Comparable) <= heapifyBlockBytes; l++) {
+        subtreeSize = subtreeSize * D + 1;
+    }
+
+    if (subtreeSize * sizeof(Comparable) <= heapifyBlockBytes) {
+        buildHeap(i);
+        return;
+    }
+
+    // the children that have children, then i
+    const size_t n = pq.size();
+    const size_t c = Layout::firstChild(i);
+    for (size_t k = c; k < std::min(c + D, n) && Layout::firstChild(k) < n; k++) {
+        buildHeapBlocked(k, levels - 1);
+    }
+    percolateDown(i);
 }
 
 /**
- * Remove and return the smallest element in the queue
+ * Remove the smallest element in the queue and return it, moved out of the queue
  */
-template <class Comparable>
-Comparable PriorityQueue<Comparable>::deleteMin() {
+template <class Comparable, std::size_t D>
+Comparable PriorityQueue<Comparable, D>::pop() {
     assert(!isEmpty());
 
-    if (!orderOK) {
-        heapify();
-    }
+    heapify();  // place the tossed elements, if any
 
-    Comparable x = pq[1];
-    Comparable y = pq[pq.size() - 1];
+    Comparable x = std::move(pq[Layout::root]);
 
-    pq[1] = y;  // set last element in the heap as the new root
-    percolateDown(1);
-    pq.pop_back();
+    if (size() > 1) {
+        pq[Layout::root] = std::move(pq.back());  // set last element in the heap as the new root
+        pq.pop_back();
+        percolateDown(Layout::root);
+    } else {
+        pq.pop_back();
+    }
+    orderedSize = pq.size();
 
 #ifdef TEST_PRIORITY_QUEUE
     assert(isMinHeap());
@@ -170,28 +399,358 @@ Comparable PriorityQueue<Comparable>::deleteMin() {
 /**
  * Insert element x on the last slot, without preserving the heap property
  */
-template <class Comparable>
-void PriorityQueue<Comparable>::toss(const Comparable& x) {
-    orderOK = false;
+template <class Comparable, std::size_t D>
+void PriorityQueue<Comparable, D>::toss(const Comparable& x) {
     pq.push_back(x);
 }
 
+template <class Comparable, std::size_t D>
+void PriorityQueue<Comparable, D>::toss(Comparable&& x) {
+    pq.push_back(std::move(x));
+}
+
 /**
- * Add a new element x to the queue
+ * Add a new element to the queue, constructed from args in the last slot
  */
-template <class Comparable>
-void PriorityQueue<Comparable>::insert(const Comparable& x) {
-    pq.push_back(x);            // Append the value at the end of the heap
-    int i = std::ssize(pq) - 1; // Starting position is the last element
+template <class Comparable, std::size_t D>
+template <class... Args>
+void PriorityQueue<Comparable, D>::emplace(Args&&... args) {
+    pq.emplace_back(std::forward<Args>(args)...);  // Append the value at the end of the heap
 
-    // Percolate up
-    while (pq[i / 2] > pq[i])
-    {
-        std::swap(pq[i / 2], pq[i]);
-        i = i / 2;
-    }
+    if (orderedSize + 1 < pq.size()) return;  // after tossed elements, heapify will place it
+
+    percolateUp(pq.size() - 1);
+    orderedSize = pq.size();
 
 #ifdef TEST_PRIORITY_QUEUE
     assert(isMinHeap());
 #endif
 }
+
+/**
+ * A min heap where every element is addressed by a handle, returned by insert
+ * An element can be changed or removed through its handle in O(log n), e.g. to remove at once
+ * the collision events of a particle that are no longer valid
+ * A handle is valid until its element leaves the queue. Its index is then reused by insert, but
+ * with a new generation, so that a stale handle, e.g. kept by the partner particle of an event,
+ * never refers to another element: contains returns false for it, and erase ignores it
+ * Every node has D children, and elements are moved inside the queue, as in PriorityQueue
+ */
+template <class Comparable, std::size_t D = 2>
+class IndexedPriorityQueue {
+public:
+    struct Handle {
+        std::size_t index;       // index in the table of handles
+        std::size_t generation;  // number of elements that had the index before
+
+        friend bool operator==(const Handle&, const Handle&) = default;
+    };
+
+    /**
+     * Constructor to create a queue with the given capacity
+     */
+    explicit IndexedPriorityQueue(int initCapacity = 100) {
+        pq.reserve(initCapacity);
+        handles.reserve(initCapacity);
+        assert(isEmpty());
+    }
+
+    /**
+     * Make the queue empty, all handles become invalid
+     */
+    void makeEmpty() {
+        // The indices are freed with the next generation, so that no handle becomes valid again
+        for (const Entry& e : pq) {
+            handles[e.index].slot = none;
+            ++handles[e.index].generation;
+            freeIndices.push_back(e.index);
+        }
+        pq.clear();
+    }
+
+    /**
+     * Check is the queue is empty
+     * Return true if the queue is empty, false otherwise
+     */
+    bool isEmpty() const {
+        return pq.empty();
+    }
+
+    /**
+     * Get the size of the queue, i.e. number of elements in the queue
+     */
+    size_t size() const { return pq.size(); }
+
+    /**
+     * Check whether the element with handle h is in the queue
+     */
+    bool contains(Handle h) const {
+        return h.index < handles.size() && handles[h.index].slot != none &&
+               handles[h.index].generation == h.generation;
+    }
+
+    /**
+     * Get the element with handle h
+     */
+    const Comparable& get(Handle h) const {
+        assert(contains(h));
+        return pq[handles[h.index].slot].value;
+    }
+
+    /**
+     * Get a copy of the smallest element in the queue
+     */
+    Comparable findMin() const {
+        assert(isEmpty() == false);
+        return pq[Layout::root].value;
+    }
+
+    /**
+     * Get the smallest element in the queue, without copying it
+     */
+    const Comparable& top() const {
+        assert(isEmpty() == false);
+        return pq[Layout::root].value;
+    }
+
+    /**
+     * Get the handle of the smallest element in the queue
+     */
+    Handle findMinHandle() const {
+        assert(isEmpty() == false);
+        return handleOf(pq[Layout::root].index);
+    }
+
+    /**
+     * Remove the smallest element in the queue and return it, moved out of the queue
+     */
+    Comparable pop();
+
+    /**
+     * Remove and return the smallest element in the queue
+     */
+    Comparable deleteMin() { return pop(); }
+
+    /**
+     * Add a new element x to the queue
+     * Return the handle of x
+     */
+    Handle insert(const Comparable& x) { return emplace(x); }
+
+    Handle insert(Comparable&& x) { return emplace(std::move(x)); }
+
+    /**
+     * Add a new element, constructed in the queue from args
+     * Return the handle of the element
+     */
+    template <class... Args>
+    Handle emplace(Args&&... args);
+
+    /**
+     * Replace the element with handle h by x, where x is not larger than the element
+     */
+    void decreaseKey(Handle h, Comparable x);
+
+    /**
+     * Replace the element with handle h by x, where x is not smaller than the element
+     */
+    void increaseKey(Handle h, Comparable x);
+
+    /**
+     * Remove the element with handle h from the queue, if it is still in the queue
+     * Return true if the element was removed, false if h is stale
+     */
+    bool erase(Handle h);
+
+private:
+    using Layout = HeapLayout<D>;
+
+    struct Entry {
+        Comparable value;
+        size_t index;  // index of the handle
+    };
+
+    struct HandleSlot {
+        size_t slot;        // slot of the element with the handle, none if none
+        size_t generation;  // generation of the handle of the element, or of the next one
+    };
+
+    static constexpr size_t none = std::numeric_limits<size_t>::max();  // slot of no element
+
+    std::vector<Entry, CacheAlignedAllocator<Entry, 1>> pq;  // the root in slot 0
+    std::vector<HandleSlot> handles;  // by the index of a handle
+    std::vector<size_t> freeIndices;  // indices not in use, below handles.size()
+
+    // Auxiliary member functions
+
+    /**
+     * Move entry e up from the hole at slot i to its place, and return that slot
+     */
+    size_t percolateUp(size_t i, Entry e);
+
+    /**
+     * Move entry e down from the hole at slot i to its place, and return that slot
+     */
+    size_t percolateDown(size_t i, Entry e);
+
+    /**
+     * Put entry e in slot i, and record the new slot of its handle
+     */
+    void place(size_t i, Entry&& e) {
+        handles[e.index].slot = i;
+        pq[i] = std::move(e);
+    }
+
+    /**
+     * Current handle with the given index
+     */
+    Handle handleOf(size_t index) const {
+        return Handle{index, handles[index].generation};
+    }
+
+    /**
+     * Remove the entry in slot i, fill the hole with the last entry
+     * The index of its handle is freed, with the next generation
+     */
+    void removeSlot(size_t i);
+
+    /**
+     * Test whether pq is a min heap, and handles agrees with the indices in pq
+     */
+    bool isIndexedMinHeap() const {
+        for (size_t i = Layout::root + 1; i < pq.size(); i++) {
+            if (pq[i].value < pq[Layout::parent(i)].value) return false;
+        }
+
+        size_t n_handles = 0;
+        for (size_t h = 0; h < handles.size(); h++) {
+            if (handles[h].slot == none) continue;
+            if (handles[h].slot >= pq.size() || pq[handles[h].slot].index != h) return false;
+            ++n_handles;
+        }
+
+        return n_handles == size() && n_handles + freeIndices.size() == handles.size();
+    }
+};
+
+template <class Comparable, std::size_t D>
+size_t IndexedPriorityQueue<Comparable, D>::percolateUp(size_t i, Entry e) {
+    while (i > Layout::root && e.value < pq[Layout::parent(i)].value) {
+        place(i, std::move(pq[Layout::parent(i)]));  // move the parent down into the hole
+        i = Layout::parent(i);
+    }
+    place(i, std::move(e));
+    return i;
+}
+
+template <class Comparable, std::size_t D>
+size_t IndexedPriorityQueue<Comparable, D>::percolateDown(size_t i, Entry e) {
+    const size_t n = pq.size();
+
+    for (size_t c = Layout::firstChild(i); c < n; c = Layout::firstChild(i)) {
+        // smallest child, among the children c to c + D - 1
+        size_t m = c;
+        const size_t last = std::min(c + D, n);
+        for (size_t k = c + 1; k < last; k++) {
+            if (pq[k].value < pq[m].value) m = k;
+        }
+
+        if (!(pq[m].value < e.value)) break;
+
+        place(i, std::move(pq[m]));  // move the child up into the hole
+        i = m;
+    }
+    place(i, std::move(e));
+    return i;
+}
+
+template <class Comparable, std::size_t D>
+void IndexedPriorityQueue<Comparable, D>::removeSlot(size_t i) {
+    const size_t index = pq[i].index;
+    handles[index].slot = none;
+    ++handles[index].generation;  // the handle becomes stale
+    freeIndices.push_back(index);
+
+    Entry last = std::move(pq.back());
+    pq.pop_back();
+
+    if (i < pq.size()) {  // fill the hole with the last entry, it may have to go up or down
+        if (i > Layout::root && last.value < pq[Layout::parent(i)].value)
+            percolateUp(i, std::move(last));
+        else
+            percolateDown(i, std::move(last));
+    }
+
+#ifdef TEST_PRIORITY_QUEUE
+    assert(isIndexedMinHeap());
+#endif
+}
+
+/**
+ * Remove the smallest element in the queue and return it, moved out of the queue
+ */
+template <class Comparable, std::size_t D>
+Comparable IndexedPriorityQueue<Comparable, D>::pop() {
+    assert(!isEmpty());
+
+    Comparable x = std::move(pq[Layout::root].value);
+    removeSlot(Layout::root);
+    return x;
+}
+
+/**
+ * Add a new element to the queue, constructed from args, with a free index or a new one
+ */
+template <class Comparable, std::size_t D>
+template <class... Args>
+typename IndexedPriorityQueue<Comparable, D>::Handle
+IndexedPriorityQueue<Comparable, D>::emplace(Args&&... args) {
+    size_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else {
+        index = handles.size();
+        handles.push_back(HandleSlot{none, 0});
+    }
+
+    pq.push_back(Entry{Comparable(std::forward<Args>(args)...), index});
+    percolateUp(pq.size() - 1, std::move(pq.back()));  // the last slot is the hole to start from
+
+#ifdef TEST_PRIORITY_QUEUE
+    assert(isIndexedMinHeap());
+#endif
+    return handleOf(index);
+}
+
+template <class Comparable, std::size_t D>
+void IndexedPriorityQueue<Comparable, D>::decreaseKey(Handle h, Comparable x) {
+    assert(contains(h));
+    assert(!(pq[handles[h.index].slot].value < x));
+
+    percolateUp(handles[h.index].slot, Entry{std::move(x), h.index});
+
+#ifdef TEST_PRIORITY_QUEUE
+    assert(isIndexedMinHeap());
+#endif
+}
+
+template <class Comparable, std::size_t D>
+void IndexedPriorityQueue<Comparable, D>::increaseKey(Handle h, Comparable x) {
+    assert(contains(h));
+    assert(!(x < pq[handles[h.index].slot].value));
+
+    percolateDown(handles[h.index].slot, Entry{std::move(x), h.index});
+
+#ifdef TEST_PRIORITY_QUEUE
+    assert(isIndexedMinHeap());
+#endif
+}
+
+template <class Comparable, std::size_t D>
+bool IndexedPriorityQueue<Comparable, D>::erase(Handle h) {
+    if (!contains(h)) return false;
+
+    removeSlot(handles[h.index].slot);
+    return true;
+}
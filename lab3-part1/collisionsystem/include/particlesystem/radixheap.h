@@ -0,0 +1,310 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// #define TEST_RADIX_HEAP
+
+/**
+ * A monotone priority queue for keys that only increase, such as the times of simulation events:
+ * an element inserted must not be smaller than the last element removed
+ * It has the same interface as PriorityQueue, so that one can replace the other at compile time
+ *
+ * The elements are ordered by key(x), an integer or floating point value, e.g. the time of an
+ * event with a Key returning x.time. Key must agree with operator< of Comparable
+ *
+ * Bucket 0 holds the elements with the key of the last element removed, and bucket b > 0 the
+ * elements whose key differs from it first in bit b - 1, counted from the least significant bit.
+ * Removing the smallest element takes it from bucket 0, or, when bucket 0 is empty, first spreads
+ * the first nonempty bucket over the buckets below it. An element moves down at most 64 buckets
+ * in its life, so insert and deleteMin take O(1) amortized time, without comparing elements
+ * top does not spread a bucket, which would forbid inserting elements smaller than the top and not
+ * smaller than the last element removed: it finds the smallest element and remembers where it is
+ */
+template <class Comparable, class Key = std::identity>
+class RadixHeap {
+public:
+    /**
+     * Constructor to create a queue with the given capacity
+     */
+    explicit RadixHeap(int initCapacity = 100) : last{0}, count{0}, minBucket{0}, minIndex{0} {
+        buckets[0].reserve(initCapacity);
+        assert(isEmpty());
+    }
+
+    /**
+     * Constructor to initialize a priority queue based on a given vector V
+     * Assumes V[0] is not used
+     */
+    explicit RadixHeap(const std::vector<Comparable>& V) : RadixHeap{0} {
+        assert(!V.empty());
+        insertRange(V.begin() + 1, V.end());
+    }
+
+    /**
+     * Make the queue empty
+     * Any element can be inserted again
+     */
+    void makeEmpty() {
+        for (auto& bucket : buckets) {
+            bucket.clear();
+        }
+        last = 0;
+        count = 0;
+        minBucket = 0;
+    }
+
+    /**
+     * Check is the queue is empty
+     * Return true if the queue is empty, false otherwise
+     */
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    /**
+     * Get the size of the queue, i.e. number of elements in the queue
+     */
+    size_t size() const { return count; }
+
+    /**
+     * Get a copy of the smallest element in the queue
+     */
+    Comparable findMin() {
+        return top();
+    }
+
+    /**
+     * Get the smallest element in the queue, without copying it
+     */
+    const Comparable& top() {
+        assert(isEmpty() == false);
+
+        if (!buckets[0].empty()) {
+            return buckets[0].back();
+        }
+        findSmallest();
+        return buckets[minBucket][minIndex];
+    }
+
+    /**
+     * Remove the smallest element in the queue and return it, moved out of the queue
+     */
+    Comparable pop();
+
+    /**
+     * Remove and return the smallest element in the queue
+     */
+    Comparable deleteMin() { return pop(); }
+
+    /**
+     * Add a new element x to the queue
+     * x must not be smaller than the last element removed
+     */
+    void insert(const Comparable& x) { emplace(x); }
+
+    void insert(Comparable&& x) { emplace(std::move(x)); }
+
+    /**
+     * Add a new element, constructed in the queue from args
+     */
+    template <class... Args>
+    void emplace(Args&&... args);
+
+    /**
+     * Same as insert: a radix heap needs no ordering to defer
+     */
+    void toss(const Comparable& x) { emplace(x); }
+
+    void toss(Comparable&& x) { emplace(std::move(x)); }
+
+    /**
+     * Add the elements in [first, last) to the queue
+     * Use std::make_move_iterator to move the elements into the queue
+     */
+    template <class InputIt>
+    void insertRange(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            emplace(*first);
+        }
+    }
+
+    template <class InputIt>
+    void tossRange(InputIt first, InputIt last) {
+        insertRange(first, last);
+    }
+
+private:
+    std::array<std::vector<Comparable>, 65> buckets;  // see the class comment
+    std::uint64_t last;  // bits of the key of the last element removed
+    size_t count;        // number of elements in all buckets
+
+    // The smallest element is buckets[minBucket][minIndex], if minBucket > 0
+    size_t minBucket;
+    size_t minIndex;
+
+    // Auxiliary member functions
+
+    /**
+     * Bits of key(x), in the same order as the keys
+     */
+    static std::uint64_t bitsOf(const Comparable& x);
+
+    /**
+     * Bucket of an element whose key has the given bits
+     */
+    size_t bucketOf(std::uint64_t bits) const {
+        return std::bit_width(bits ^ last);
+    }
+
+    /**
+     * Find the smallest element, in the first nonempty bucket, when bucket 0 is empty
+     */
+    void findSmallest();
+
+    /**
+     * Make bucket 0 nonempty, by spreading the first nonempty bucket over the buckets below it
+     */
+    void refill();
+
+    /**
+     * Test whether every element is in its bucket, and the smallest element is where it is said
+     */
+    bool isRadixHeap() const {
+        size_t n = 0;
+        for (size_t b = 0; b < buckets.size(); b++) {
+            for (const Comparable& x : buckets[b]) {
+                if (bitsOf(x) < last || bucketOf(bitsOf(x)) != b) return false;
+            }
+            n += buckets[b].size();
+        }
+
+        if (minBucket > 0) {  // the smallest element, in the first nonempty bucket
+            for (size_t b = 0; b < minBucket; b++) {
+                if (!buckets[b].empty()) return false;
+            }
+            for (const Comparable& x : buckets[minBucket]) {
+                if (bitsOf(x) < bitsOf(buckets[minBucket][minIndex])) return false;
+            }
+        }
+
+        return n == count;
+    }
+};
+
+/**
+ * Map the key to 64 bits that compare as the keys do: flip the sign bit of signed integers, and
+ * for floating point numbers also all other bits of negative numbers
+ */
+template <class Comparable, class Key>
+std::uint64_t RadixHeap<Comparable, Key>::bitsOf(const Comparable& x) {
+    using K = std::remove_cvref_t<std::invoke_result_t<Key, const Comparable&>>;
+    static_assert(std::is_arithmetic_v<K> && sizeof(K) <= 8, "a key is a number of 64 bits");
+
+    const K key = std::invoke(Key{}, x);
+    constexpr std::uint64_t signBit = std::uint64_t{1} << 63;
+
+    if constexpr (std::is_floating_point_v<K>) {
+        assert(key == key);  // not a NaN
+        const auto bits = std::bit_cast<std::uint64_t>(static_cast<double>(key) + 0.0);  // no -0
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    } else if constexpr (std::is_signed_v<K>) {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(key)) ^ signBit;
+    } else {
+        return static_cast<std::uint64_t>(key);
+    }
+}
+
+template <class Comparable, class Key>
+void RadixHeap<Comparable, Key>::findSmallest() {
+    assert(buckets[0].empty() && count > 0);
+    if (minBucket > 0) return;  // known
+
+    size_t b = 1;
+    while (buckets[b].empty()) {
+        b++;
+    }
+
+    minBucket = b;
+    minIndex = 0;
+    std::uint64_t smallest = bitsOf(buckets[b][0]);
+    for (size_t i = 1; i < buckets[b].size(); i++) {
+        const std::uint64_t bits = bitsOf(buckets[b][i]);
+        if (bits < smallest) {
+            smallest = bits;
+            minIndex = i;
+        }
+    }
+}
+
+template <class Comparable, class Key>
+void RadixHeap<Comparable, Key>::refill() {
+    if (!buckets[0].empty()) return;
+
+    findSmallest();
+    const size_t b = minBucket;
+    minBucket = 0;
+
+    // The smallest key in bucket b becomes last, so that its elements go to bucket 0, and all
+    // others to buckets below b: they share the bits above bit b - 1 with it
+    last = bitsOf(buckets[b][minIndex]);
+
+    for (Comparable& x : buckets[b]) {
+        const size_t to = bucketOf(bitsOf(x));
+        assert(to < b);
+        buckets[to].push_back(std::move(x));
+    }
+    buckets[b].clear();
+
+#ifdef TEST_RADIX_HEAP
+    assert(isRadixHeap());
+#endif
+}
+
+/**
+ * Remove the smallest element in the queue and return it, moved out of the queue
+ */
+template <class Comparable, class Key>
+Comparable RadixHeap<Comparable, Key>::pop() {
+    assert(!isEmpty());
+
+    refill();
+
+    Comparable x = std::move(buckets[0].back());
+    buckets[0].pop_back();
+    --count;
+    return x;
+}
+
+/**
+ * Add a new element to the queue, constructed from args
+ */
+template <class Comparable, class Key>
+template <class... Args>
+void RadixHeap<Comparable, Key>::emplace(Args&&... args) {
+    Comparable x(std::forward<Args>(args)...);
+    const std::uint64_t bits = bitsOf(x);
+    assert(bits >= last);  // not smaller than the last element removed
+
+    const size_t b = bucketOf(bits);
+    buckets[b].push_back(std::move(x));
+    ++count;
+
+    // A new smallest element, unless bucket 0 has elements, which are not larger
+    if (minBucket > 0 && bits < bitsOf(buckets[minBucket][minIndex])) {
+        minBucket = b;
+        minIndex = buckets[b].size() - 1;
+    }
+
+#ifdef TEST_RADIX_HEAP
+    assert(isRadixHeap());
+#endif
+}